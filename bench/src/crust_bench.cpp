@@ -0,0 +1,240 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <common/corpusgenerator.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <parser/lexer.hpp>
+#include <parser/parser.hpp>
+#include <parser/tokenview.hpp>
+#include <sstream>
+#include <string>
+
+using namespace Crust;
+
+/*
+ * Lexer and parser throughput
+ *
+ * Every benchmark reports bytes and tokens per second, and allocs_per_byte: the heap allocations
+ * made while timing, divided by the bytes processed. Allocations are counted by replacing the
+ * global operator new of this executable. Build without CRUST_TRACE, which records every token.
+ */
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+// Allocations made from now until the destructor, reported per byte processed
+class AllocationCounter {
+   public:
+    explicit AllocationCounter(benchmark::State& state) : mState{state}, mStart{allocations.load()} {}
+    ~AllocationCounter() {
+        const double bytes = double(mState.bytes_processed());
+        mState.counters["allocs_per_byte"] = bytes > 0 ? double(allocations.load() - mStart) / bytes : 0.0;
+    }
+
+   private:
+    benchmark::State& mState;
+    std::size_t mStart;
+};
+
+std::string programPath(const std::string& name) {
+    return std::string(CRUST_SOURCE_DIR) + "/" + name + ".crst";
+}
+
+// Synthetic programs are parsed from a file, since that is what Parser::parseProgram reads
+std::string writeProgram(std::size_t size) {
+    const std::string path = (std::filesystem::temp_directory_path() / ("crust_bench_mixed_" + std::to_string(size) + ".crst")).string();
+    if (!std::filesystem::exists(path)) {
+        std::ofstream out(path);
+        CorpusGenerator({CorpusGenerator::Shape::MIXED, size, 4, 1}).generate(out);
+    }
+    return path;
+}
+
+// Programs whose size is one list of count elements
+enum class LongList { DECLS, STMTS, VARS, PARAMS, ARGS, OPERANDS };
+
+std::string writeList(LongList list, std::size_t count) {
+    static constexpr const char* names[] = {"decls", "stmts", "vars", "params", "args", "operands"};
+    const std::string path = (std::filesystem::temp_directory_path() /
+                              ("crust_bench_" + std::string(names[(int)list]) + "_" + std::to_string(count) + ".crst"))
+                                 .string();
+    if (std::filesystem::exists(path))
+        return path;
+
+    std::ofstream out(path);
+    switch (list) {
+        case LongList::DECLS:
+            for (std::size_t idx = 0; idx < count; ++idx) out << "i32 v" << idx << ";\n";
+            break;
+        case LongList::STMTS:
+            out << "fn f() void {\n";
+            for (std::size_t idx = 0; idx < count; ++idx) out << "    v = " << idx << ";\n";
+            out << "}\n";
+            break;
+        case LongList::VARS:
+            out << "i32 v0";
+            for (std::size_t idx = 1; idx < count; ++idx) out << ", v" << idx;
+            out << ";\n";
+            break;
+        case LongList::PARAMS:
+            out << "fn f(i32 p0";
+            for (std::size_t idx = 1; idx < count; ++idx) out << ", i32 p" << idx;
+            out << ") void {\n}\n";
+            break;
+        case LongList::ARGS:
+            out << "fn f() void {\n    g(0";
+            for (std::size_t idx = 1; idx < count; ++idx) out << ", " << idx;
+            out << ");\n}\n";
+            break;
+        case LongList::OPERANDS: {
+            // Every precedence level in turn
+            static constexpr const char* operators[] = {" * ", " + ", " < ", " == ", " and ", " or ", " - ", " / "};
+            out << "fn f() void {\n    v = 0";
+            for (std::size_t idx = 1; idx < count; ++idx) out << operators[idx % 8] << idx;
+            out << ";\n}\n";
+            break;
+        }
+    }
+    return path;
+}
+
+// Tokens counted by calling getNextToken, by a TokenView or by generateTokens
+enum class LexLoop { CALLS, VIEW, GENERATOR };
+
+std::size_t countTokens(Lexer& lexer, LexLoop loop) {
+    std::size_t tokens = 0;
+    switch (loop) {
+        case LexLoop::CALLS:
+            while (lexer.getNextToken() != Lexer::Token::TOK_EOF) ++tokens;
+            break;
+        case LexLoop::VIEW:
+            for (const LexedToken& token : TokenView(lexer)) {
+                benchmark::DoNotOptimize(token);
+                ++tokens;
+            }
+            break;
+        case LexLoop::GENERATOR:
+            for (const LexedToken& token : generateTokens(lexer)) {
+                benchmark::DoNotOptimize(token);
+                ++tokens;
+            }
+            break;
+    }
+    return tokens;
+}
+
+void lex(benchmark::State& state, const std::string& path, LexLoop loop = LexLoop::CALLS) {
+    const auto source = SourceBuffer::fromFile(path);
+    std::size_t tokens = 0;
+    {
+        AllocationCounter counter(state);
+        for (auto _ : state) {
+            Lexer lexer;
+            lexer.init(source);
+            tokens += countTokens(lexer, loop);
+        }
+        state.SetBytesProcessed(state.iterations() * source->getSize());
+    }
+    state.counters["tokens_per_second"] = benchmark::Counter(double(tokens), benchmark::Counter::kIsRate);
+}
+
+void parse(benchmark::State& state, const std::string& path, bool pipelined = false,
+           Parser::Backend backend = Parser::Backend::HANDWRITTEN) {
+    const std::size_t size = std::filesystem::file_size(path);
+    AllocationCounter counter(state);
+    for (auto _ : state) {
+        Parser parser;
+        parser.setPipelined(pipelined);
+        parser.setBackend(backend);
+        auto program = parser.parseProgram(path);
+        benchmark::DoNotOptimize(program);
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+void print(benchmark::State& state, const std::string& path) {
+    const std::size_t size = std::filesystem::file_size(path);
+    Parser parser;
+    const auto program = parser.parseProgram(path);
+
+    AllocationCounter counter(state);
+    for (auto _ : state) {
+        std::ostringstream stream;
+        stream << *program;
+        benchmark::DoNotOptimize(stream);
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+void BM_LexProgram(benchmark::State& state, const char* name) { lex(state, programPath(name)); }
+void BM_ParseProgram(benchmark::State& state, const char* name) { parse(state, programPath(name)); }
+void BM_PrintProgram(benchmark::State& state, const char* name) { print(state, programPath(name)); }
+
+void BM_LexSynthetic(benchmark::State& state) { lex(state, writeProgram(state.range(0))); }
+void BM_LexSyntheticView(benchmark::State& state) { lex(state, writeProgram(state.range(0)), LexLoop::VIEW); }
+void BM_LexSyntheticGenerator(benchmark::State& state) { lex(state, writeProgram(state.range(0)), LexLoop::GENERATOR); }
+void BM_ParseSynthetic(benchmark::State& state) { parse(state, writeProgram(state.range(0))); }
+void BM_ParseSyntheticPipelined(benchmark::State& state) { parse(state, writeProgram(state.range(0)), true); }
+void BM_ParseSyntheticTable(benchmark::State& state) {
+    parse(state, writeProgram(state.range(0)), false, Parser::Backend::TABLE);
+}
+void BM_PrintSynthetic(benchmark::State& state) { print(state, writeProgram(state.range(0))); }
+void BM_ParseList(benchmark::State& state, LongList list) { parse(state, writeList(list, state.range(0))); }
+void BM_ParseListTable(benchmark::State& state, LongList list) {
+    parse(state, writeList(list, state.range(0)), false, Parser::Backend::TABLE);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+// The full programs predate the current grammar, so parsing them also times the error recovery
+BENCHMARK_CAPTURE(BM_LexProgram, fact, "full/fact");
+BENCHMARK_CAPTURE(BM_LexProgram, sort, "full/sort");
+BENCHMARK_CAPTURE(BM_LexProgram, swap, "full/swap");
+BENCHMARK_CAPTURE(BM_LexProgram, functions, "parser/functions");
+BENCHMARK_CAPTURE(BM_ParseProgram, fact, "full/fact");
+BENCHMARK_CAPTURE(BM_ParseProgram, sort, "full/sort");
+BENCHMARK_CAPTURE(BM_ParseProgram, swap, "full/swap");
+BENCHMARK_CAPTURE(BM_ParseProgram, functions, "parser/functions");
+BENCHMARK_CAPTURE(BM_PrintProgram, fact, "full/fact");
+BENCHMARK_CAPTURE(BM_PrintProgram, sort, "full/sort");
+BENCHMARK_CAPTURE(BM_PrintProgram, swap, "full/swap");
+BENCHMARK_CAPTURE(BM_PrintProgram, functions, "parser/functions");
+
+BENCHMARK(BM_LexSynthetic)->RangeMultiplier(8)->Range(16 << 10, 16 << 20)->Unit(benchmark::kMillisecond);
+// Same work as BM_LexSynthetic through the range interfaces, which should not allocate per token
+BENCHMARK(BM_LexSyntheticView)->RangeMultiplier(8)->Range(16 << 10, 16 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LexSyntheticGenerator)->RangeMultiplier(8)->Range(16 << 10, 16 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseSynthetic)->RangeMultiplier(4)->Range(16 << 10, 256 << 10)->Unit(benchmark::kMillisecond);
+// Lexes on a second thread, compare with BM_ParseSynthetic for the speedup
+BENCHMARK(BM_ParseSyntheticPipelined)->RangeMultiplier(4)->Range(16 << 10, 256 << 10)->Unit(benchmark::kMillisecond)->UseRealTime();
+// The generated LL(1) tables, compare with BM_ParseSynthetic
+BENCHMARK(BM_ParseSyntheticTable)->RangeMultiplier(4)->Range(16 << 10, 256 << 10)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PrintSynthetic)->RangeMultiplier(4)->Range(16 << 10, 256 << 10)->Unit(benchmark::kMillisecond);
+
+// Lists are parsed by loops, so the stack stays flat however long they get
+BENCHMARK_CAPTURE(BM_ParseList, decls, LongList::DECLS)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseList, stmts, LongList::STMTS)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseList, vars, LongList::VARS)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseList, params, LongList::PARAMS)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseList, args, LongList::ARGS)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseList, operands, LongList::OPERANDS)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Unit(benchmark::kMillisecond);
+// The table driver expands the same lists as right recursive rules on its own stack
+BENCHMARK_CAPTURE(BM_ParseListTable, decls, LongList::DECLS)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseListTable, stmts, LongList::STMTS)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ParseListTable, operands, LongList::OPERANDS)->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <parser/keywords.hpp>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Crust;
+
+namespace {
+
+// The comparison chain Lexer::tokenizeCurrentStr used before Keywords
+Lexer::Token classifyChain(std::string_view str) {
+    if (str == "i32")
+        return Lexer::Token::KW_INT_32;
+    else if (str == "i64")
+        return Lexer::Token::KW_INT_64;
+    else if (str == "u32")
+        return Lexer::Token::KW_UINT_32;
+    else if (str == "u64")
+        return Lexer::Token::KW_UINT_64;
+    else if (str == "f32")
+        return Lexer::Token::KW_FLOAT_32;
+    else if (str == "f64")
+        return Lexer::Token::KW_FLOAT_64;
+    else if (str == "string")
+        return Lexer::Token::KW_STRING;
+    else if (str == "bool")
+        return Lexer::Token::KW_BOOL;
+    else if (str == "void")
+        return Lexer::Token::KW_VOID;
+    else if (str == "true")
+        return Lexer::Token::KW_TRUE;
+    else if (str == "false")
+        return Lexer::Token::KW_FALSE;
+    else if (str == "let")
+        return Lexer::Token::KW_LET;
+    else if (str == "if")
+        return Lexer::Token::KW_IF;
+    else if (str == "elif")
+        return Lexer::Token::KW_ELIF;
+    else if (str == "else")
+        return Lexer::Token::KW_ELSE;
+    else if (str == "for")
+        return Lexer::Token::KW_FOR;
+    else if (str == "in")
+        return Lexer::Token::KW_IN;
+    else if (str == "while")
+        return Lexer::Token::KW_WHILE;
+    else if (str == "fn")
+        return Lexer::Token::KW_FN;
+    else if (str == "return")
+        return Lexer::Token::KW_RETURN;
+    else if (str == "and")
+        return Lexer::Token::OP_AND;
+    else if (str == "or")
+        return Lexer::Token::OP_OR;
+    else
+        return Lexer::Token::IDENTIFIER;
+}
+
+// Words drawn like a typical program: mostly identifiers, a quarter keywords
+std::vector<std::string> makeWords(std::size_t count) {
+    static const char* identifiers[] = {"x", "i", "idx", "count", "arr", "temp", "result", "n", "swap",
+                                        "bubbleSort", "main", "value", "left", "right", "fib", "sum"};
+
+    std::mt19937 rng(42);
+    std::vector<std::string> words;
+    words.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (rng() % 4 == 0)
+            words.emplace_back(Keywords::all[rng() % Keywords::all.size()].spelling);
+        else
+            words.emplace_back(identifiers[rng() % std::size(identifiers)]);
+    }
+    return words;
+}
+
+template <typename Classify>
+double run(const char* name, const std::vector<std::string>& words, unsigned rounds, Classify classify) {
+    unsigned checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned round = 0; round < rounds; ++round)
+        for (const auto& word : words)
+            checksum += static_cast<unsigned>(classify(std::string_view(word)));
+    const auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count() / (double(words.size()) * rounds);
+    std::cout << name << ": " << ns << " ns/word (checksum " << checksum << ")\n";
+    return ns;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const unsigned rounds = argc > 1 ? std::atoi(argv[1]) : 50;
+    const auto words = makeWords(1 << 16);
+
+    for (const auto& word : words) {
+        if (classifyChain(word) != Keywords::classify(word)) {
+            std::cerr << "Mismatch on \"" << word << "\"\n";
+            return 1;
+        }
+    }
+
+    const double chain = run("if-chain    ", words, rounds, classifyChain);
+    const double hashed = run("perfect hash", words, rounds, [](std::string_view word) { return Keywords::classify(word); });
+    std::cout << "speedup: " << chain / hashed << "x\n";
+    return 0;
+}
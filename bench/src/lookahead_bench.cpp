@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <parser/lexer.hpp>
+#include <string>
+
+using namespace Crust;
+
+namespace {
+
+// Identifier-heavy statements, the case where Parser peeks after every identifier
+std::shared_ptr<const SourceBuffer> makeSource(std::size_t size) {
+    static const char* statements =
+        "total = total + values[idx] * scale(weight, offset);\n"
+        "count = count + 1;\n"
+        "result = combine(left, right, pivot) - bias;\n";
+
+    std::string source;
+    source.reserve(size + 256);
+    while (source.size() < size) source += statements;
+    return SourceBuffer::fromString(std::move(source));
+}
+
+// Lexes the whole source and looks one token ahead after every identifier, in ns per token. The
+// source has no comments, and getNextToken would print every token in debug builds
+template <typename Peek>
+double run(const std::shared_ptr<const SourceBuffer>& source, Peek peek) {
+    Lexer lexer;
+    lexer.init(source);
+
+    std::size_t tokens = 0;
+    std::size_t calls = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (Lexer::Token token = lexer.getNextTokenAndComment(); token != Lexer::Token::TOK_EOF; token = lexer.getNextTokenAndComment()) {
+        ++tokens;
+        if (token == Lexer::Token::IDENTIFIER and peek(lexer) == Lexer::Token::LPAREN)
+            ++calls;
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    if (calls == 0)
+        std::cerr << "No call found\n";
+    return std::chrono::duration<double, std::nano>(end - start).count() / tokens;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t megabytes = argc > 1 ? std::atoi(argv[1]) : 10;
+
+    // A linear lookahead costs the same per token whatever the size of the input
+    std::cout << "size       copy (ns/token)   checkpoint (ns/token)\n";
+    for (std::size_t size = (megabytes << 20) / 8; size <= (megabytes << 20); size *= 2) {
+        const auto source = makeSource(size);
+
+        const double copy = run(source, [](const Lexer& lexer) {
+            Lexer lexerCopy = lexer;
+            return lexerCopy.getNextTokenAndComment();
+        });
+        const double checkpoint = run(source, [](Lexer& lexer) {
+            const Lexer::Checkpoint saved = lexer.save();
+            const Lexer::Token next = lexer.getNextTokenAndComment();
+            lexer.restore(saved);
+            return next;
+        });
+
+        std::cout << (size >> 10) << " KiB   " << copy << "   " << checkpoint << "\n";
+    }
+    return 0;
+}
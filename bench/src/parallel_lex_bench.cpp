@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <parser/lexer.hpp>
+#include <parser/tokentable.hpp>
+#include <string>
+#include <thread>
+
+using namespace Crust;
+
+namespace {
+
+// Repeats a small program until the source is at least size bytes
+std::string makeSource(std::size_t size) {
+    static const char* program =
+        "fn bubbleSort(arr: i32[], n: i32) -> void {\n"
+        "    for i in 0..n {\n"
+        "        for j in 0..n - i - 1 {\n"
+        "            if arr[j] > arr[j + 1] {\n"
+        "                swap(&arr[j], &arr[j + 1]); // keep the larger one last\n"
+        "            }\n"
+        "        }\n"
+        "    }\n"
+        "}\n"
+        "let scale: f32 = 1.5;\n"
+        "let name: string = \"sorted\";\n";
+
+    std::string source;
+    source.reserve(size + 512);
+    while (source.size() < size) source += program;
+    return source;
+}
+
+// Best of rounds, in milliseconds
+double run(const std::shared_ptr<const SourceBuffer>& source, unsigned threads, unsigned rounds, std::size_t& count) {
+    double best = 0;
+    for (unsigned round = 0; round < rounds; ++round) {
+        Lexer lexer;
+        lexer.init(source);
+
+        const auto start = std::chrono::steady_clock::now();
+        const TokenTable tokens = threads == 1 ? lexer.lexAll() : lexer.lexAllParallel(threads);
+        const auto end = std::chrono::steady_clock::now();
+
+        const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        best = round == 0 ? ms : std::min(best, ms);
+        count = tokens.size();
+    }
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t megabytes = argc > 1 ? std::atoi(argv[1]) : 64;
+    const unsigned maxThreads = argc > 2 ? std::atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    const unsigned rounds = 3;
+
+    const auto source = SourceBuffer::fromString(makeSource(megabytes << 20));
+
+    std::size_t expected = 0;
+    const double sequential = run(source, 1, rounds, expected);
+    std::cout << "threads  1: " << sequential << " ms, " << expected << " tokens\n";
+
+    for (unsigned threads = 2; threads <= maxThreads; ++threads) {
+        std::size_t count = 0;
+        const double ms = run(source, threads, rounds, count);
+        if (count != expected) {
+            std::cerr << "Token count mismatch with " << threads << " threads\n";
+            return 1;
+        }
+        std::cout << "threads " << (threads < 10 ? " " : "") << threads << ": " << ms << " ms, speedup " << sequential / ms << "x\n";
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <parser/lexer.hpp>
+#include <parser/tokentable.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Crust;
+
+namespace {
+
+std::string makeSource(std::size_t lines) {
+    static const char* statements[] = {
+        "let count: i32 = 0;\n",
+        "    total = total + values[idx] * 1.5; // accumulate\n",
+        "    if total > limit { return \"overflow\"; }\n",
+        "fn scale(value: f32, factor: f32) -> f32 { return value * factor; }\n",
+    };
+
+    std::string source;
+    for (std::size_t line = 0; line < lines; ++line) source += statements[line % std::size(statements)];
+    return source;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t lines = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const unsigned edits = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    Lexer lexer;
+    lexer.init(SourceBuffer::fromString(makeSource(lines)));
+
+    auto start = std::chrono::steady_clock::now();
+    TokenTable tokens = lexer.lexAll();
+    const double full = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    // Typing: insert a character, then delete it again, at random places
+    std::mt19937 rng(5);
+    std::vector<double> times;
+    for (unsigned edit = 0; edit < edits; ++edit) {
+        const std::size_t offset = rng() % tokens.getSource().size();
+
+        start = std::chrono::steady_clock::now();
+        lexer.relex(tokens, {offset, 0, "x"});
+        lexer.relex(tokens, {offset, 1, ""});
+        times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 2);
+    }
+    std::sort(times.begin(), times.end());
+
+    std::cout << lines << " lines, " << tokens.size() << " tokens\n";
+    std::cout << "lexAll: " << full << " us\n";
+    std::cout << "relex:  " << times[times.size() / 2] << " us median, " << times[times.size() * 9 / 10] << " us p90\n";
+    return 0;
+}
@@ -8,8 +8,8 @@
 #include <memory>
 #include <ostream>
 #include <parser/lexer.hpp>
-#include <set>
 #include <string>
+#include <utility>
 #include <utils/uid.hpp>
 #include <vector>
 
@@ -30,15 +30,13 @@ class CFGNode {
 
         VAR_DECL,
         VAR_DECL_LIST,
-        VAR_DECL_LIST_,
 
         FN_DECL,
         FN_PARAM_LIST,
-        FN_PARAM_LIST_,
         FN_PARAM,
 
         EXPRESSION,
-        EXPRESSION_RHS,
+        BINARY_EXPRESSION,
 
         TERM,
         FLOAT_TERM,
@@ -46,7 +44,6 @@ class CFGNode {
         CALL,
         CALL_PARAM_LIST,
         CALL_PARAM,
-        CALL_PARAM_LIST_,
 
         STMT_LIST,
         STMT,
@@ -77,9 +74,23 @@ class CFGNode {
 
    public:
     // explicit CFGNode(NodeKind kind = NodeKind::ERROR) : mUid{UID::generate()}, mKind{kind}, mName{" "} {}
-    explicit CFGNode(NodeKind kind = NodeKind::ERROR, std::string name = "") : mUid{UID::generate()}, mKind{kind}, mName{name} {}
-
-    virtual ~CFGNode() = default;
+    explicit CFGNode(NodeKind kind = NodeKind::ERROR, std::string name = "") : mUid{UID::generate()}, mKind{kind}, mName{std::move(name)} {}
+    CFGNode(NodeKind kind, std::string name, ChildrenNode&& children)
+        : mUid{UID::generate()}, mKind{kind}, mName{std::move(name)}, mChildren{std::move(children)} {}
+
+    // Iterative, a chain of a million operators is a tree a million nodes deep
+    virtual ~CFGNode() {
+        ChildrenNode pending = std::move(mChildren);
+        while (!pending.empty()) {
+            const std::unique_ptr<CFGNode> node = std::move(pending.back());
+            pending.pop_back();
+            if (!node)
+                continue;
+            // Destroyed childless at the end of the iteration
+            for (auto& child : node->mChildren) pending.push_back(std::move(child));
+            node->mChildren.clear();
+        }
+    }
 
     CFGNode(const CFGNode&) = default;
     CFGNode(CFGNode&&) = default;
@@ -89,10 +100,9 @@ class CFGNode {
    public:
     uint64_t getUID() const { return mUid; }
     NodeKind getKind() const { return mKind; }  // Why not const?
-    const std::string& getName() const { return mName; }
+    virtual const std::string& getName() const { return mName; }
     const ChildrenNode& getChildrenNodes() const { return mChildren; }
     const SourceLocation& getSourceLocation() const { return mSrcLoc; }
-    std::set<Lexer::Token> first;
 
     void addChildNode(std::unique_ptr<CFGNode>&& node) { mChildren.push_back(std::move(node)); }
 
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <CFG/cfg.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <parser/lexer.hpp>
+
+namespace Crust {
+
+/*
+ * \class TokenSet
+ * \brief A set of tokens as a 64-bit mask, one bit per Lexer::Token
+ */
+class TokenSet {
+   public:
+    constexpr TokenSet() = default;
+    constexpr TokenSet(std::initializer_list<Lexer::Token> tokens) {
+        for (Lexer::Token token : tokens) mBits |= bit(token);
+    }
+
+    // Every token from first to last, both included
+    static constexpr TokenSet range(Lexer::Token first, Lexer::Token last) {
+        TokenSet set;
+        for (unsigned t = (unsigned)first; t <= (unsigned)last; ++t) set.mBits |= std::uint64_t{1} << t;
+        return set;
+    }
+
+    constexpr bool contains(Lexer::Token token) const { return (mBits & bit(token)) != 0; }
+    constexpr bool empty() const { return mBits == 0; }
+    constexpr std::uint64_t getBits() const { return mBits; }
+
+    constexpr TokenSet operator|(TokenSet other) const {
+        TokenSet set;
+        set.mBits = mBits | other.mBits;
+        return set;
+    }
+
+    constexpr bool operator==(const TokenSet&) const = default;
+
+   private:
+    static constexpr std::uint64_t bit(Lexer::Token token) { return std::uint64_t{1} << (unsigned)token; }
+
+   private:
+    std::uint64_t mBits = 0;
+};
+
+static_assert((unsigned)Lexer::Token::UNKNOWN < 64, "Every token needs a bit of TokenSet");
+
+/*
+ * \class FirstSets
+ * \brief FIRST set of every rule of the grammar, indexed by the NodeKind of the rule
+ *
+ * A parse function skips the tokens that cannot start its rule, and with the sets in a constexpr table
+ * that test is a single AND against a constant mask. Rules that may derive the empty string also
+ * accept the tokens that can follow them. TOKEN and ERROR have empty sets.
+ */
+class FirstSets {
+   public:
+    FirstSets() = delete;
+
+    static constexpr TokenSet get(CFGNode::NodeKind kind) { return sets[(std::size_t)kind]; }
+
+   private:
+    using Kind = CFGNode::NodeKind;
+    using T = Lexer::Token;
+
+    static constexpr TokenSet TYPES = TokenSet::range(T::KW_INT_32, T::KW_VOID) | TokenSet{T::LBRACKET};
+    static constexpr TokenSet TERM_START = {T::LPAREN, T::OP_MINUS, T::KW_TRUE, T::KW_FALSE,
+                                            T::STR_LITERAL, T::IDENTIFIER, T::FLOAT_LITERAL, T::INT_LITERAL};
+    static constexpr TokenSet STMT_START = TYPES | TERM_START |
+                                           TokenSet{T::LBRACE, T::KW_IF, T::KW_FOR, T::KW_WHILE, T::KW_RETURN};
+    static constexpr TokenSet DECL_START = TYPES | TokenSet{T::KW_FN};
+
+    static constexpr std::array<TokenSet, (std::size_t)Kind::ERROR + 1> sets = [] {
+        std::array<TokenSet, (std::size_t)Kind::ERROR + 1> first{};
+        auto set = [&](Kind kind, TokenSet tokens) { first[(std::size_t)kind] = tokens; };
+
+        set(Kind::PROG_DECL, DECL_START);
+        set(Kind::DECL_LIST, DECL_START);
+        set(Kind::DECL, DECL_START);
+
+        set(Kind::VAR_DECL, TYPES);
+        set(Kind::VAR_DECL_LIST, {T::IDENTIFIER});
+
+        set(Kind::FN_DECL, {T::KW_FN});
+        set(Kind::FN_PARAM_LIST, TYPES | TokenSet{T::RPAREN});
+        set(Kind::FN_PARAM, TYPES);
+
+        set(Kind::EXPRESSION, TERM_START);
+        // Tokens after an operand: an operator, or one that can follow the expression
+        set(Kind::BINARY_EXPRESSION, TokenSet::range(T::OP_PLUS, T::OP_LT) |
+                                         TokenSet{T::RPAREN, T::RBRACKET, T::COMMA, T::SEMI_COLON, T::LBRACE, T::RANGE});
+
+        set(Kind::TERM, TERM_START);
+        set(Kind::FLOAT_TERM, {T::FLOAT_LITERAL, T::INT_LITERAL});
+        set(Kind::ARRAY_SUBSCRIPT, {T::IDENTIFIER});
+        set(Kind::CALL, {T::IDENTIFIER});
+        set(Kind::CALL_PARAM_LIST, TERM_START | TokenSet{T::RPAREN});
+        set(Kind::CALL_PARAM, TERM_START);
+
+        set(Kind::STMT_LIST, STMT_START | TokenSet{T::RBRACE});
+        set(Kind::STMT, STMT_START);
+        set(Kind::ASSIGNMENT_STMT, {T::IDENTIFIER});
+        set(Kind::CONDITIONAL_STMT, {T::KW_IF});
+        set(Kind::LOOP_STMT, {T::KW_FOR, T::KW_WHILE});
+        set(Kind::RETURN_STMT, {T::KW_RETURN});
+
+        set(Kind::IF_BLOCK, {T::KW_IF});
+        set(Kind::ELIF_BLOCKS, STMT_START | TokenSet{T::KW_ELIF, T::KW_ELSE, T::RBRACE});
+        set(Kind::ELIF_BLOCK, {T::KW_ELIF});
+        set(Kind::ELSE_BLOCK, STMT_START | TokenSet{T::KW_ELSE, T::RBRACE});
+
+        set(Kind::FOR_LOOP, {T::KW_FOR});
+        set(Kind::LOOP_RANGE, TERM_START);
+        set(Kind::LOOP_STEP, {T::RANGE, T::LBRACE});
+
+        set(Kind::WHILE_LOOP, {T::KW_WHILE});
+
+        set(Kind::RETURN_VAR, TERM_START | TokenSet{T::SEMI_COLON});
+
+        set(Kind::SEGMENT, {T::LBRACE});
+        set(Kind::TYPE, TYPES);
+        return first;
+    }();
+};
+
+}  // namespace Crust
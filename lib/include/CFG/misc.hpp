@@ -1,20 +1,18 @@
 #pragma once
 
 #include <CFG/cfg.hpp>
+#include <array>
+#include <common/symbolpool.hpp>
+#include <cstddef>
 #include <parser/lexer.hpp>
 #include <string>
+#include <string_view>
 
 namespace Crust {
 
 class Segment : public CFGNode {
-    void generate_first() {
-        first.insert(Lexer::Token::LBRACE);
-    }
-
    public:
-    Segment() : CFGNode(NodeKind::ERROR, "ERROR") {
-        generate_first();
-    }
+    Segment() : CFGNode(NodeKind::ERROR, "ERROR") {}
 
     Segment(std::unique_ptr<CFGNode>&& lbracket,
             std::unique_ptr<CFGNode>&& stmtList,
@@ -22,8 +20,6 @@ class Segment : public CFGNode {
         addChildNode(std::move(lbracket));
         addChildNode(std::move(stmtList));
         addChildNode(std::move(rbracket));
-
-        generate_first();
     }
 };
 
@@ -33,44 +29,58 @@ class Token : public CFGNode {
     }
 
     Token(Lexer::Token token) : CFGNode(NodeKind::TOKEN), mToken(token) {
-        mName = "TOKEN_" + Lexer::token_to_str[(size_t)mToken];
     }
 
-    Token(Lexer::Token token, std::string identifier_val) : CFGNode(NodeKind::TOKEN), mToken(token) {
-        mName = "TOKEN_" + Lexer::token_to_str[(size_t)mToken] + "(" + identifier_val + ")";
+    Token(Lexer::Token token, Symbol symbol) : CFGNode(NodeKind::TOKEN), mToken(token), mSymbol(symbol) {
     }
 
-    Token(Lexer::Token token, int int_literal) : CFGNode(NodeKind::TOKEN), mToken(token) {
+    Token(Lexer::Token token, std::uint64_t int_literal) : CFGNode(NodeKind::TOKEN), mToken(token) {
         mName = "TOKEN_" + Lexer::token_to_str[(size_t)mToken] + "(" + std::to_string(int_literal) + ")";
     }
 
-    Token(Lexer::Token token, float float_literal) : CFGNode(NodeKind::TOKEN), mToken(token) {
+    Token(Lexer::Token token, double float_literal) : CFGNode(NodeKind::TOKEN), mToken(token) {
         mName = "TOKEN_" + Lexer::token_to_str[(size_t)mToken] + "(" + std::to_string(float_literal) + ")";
     }
 
+    // Names without a payload are shared by every token of a kind. The name of an identifier or a
+    // string literal is only built the first time it is asked for, so until then it is stored once, in
+    // the symbol pool
+    const std::string& getName() const override {
+        if (!mName.empty())
+            return mName;
+        if (!mSymbol.isValid())
+            return kindName(mToken);
+
+        if (mSymbolName.empty())
+            mSymbolName = kindName(mToken) + "(" + std::string(SymbolPool::global().get(mSymbol)) + ")";
+        return mSymbolName;
+    }
+
     Lexer::Token getToken() const { return mToken; }
+    Symbol getSymbol() const { return mSymbol; }
+
+   private:
+    static const std::string& kindName(Lexer::Token token) {
+        static const auto names = [] {
+            std::array<std::string, Lexer::token_to_str.size()> names;
+            for (std::size_t idx = 0; idx < names.size(); ++idx) names[idx] = "TOKEN_" + Lexer::token_to_str[idx];
+            return names;
+        }();
+        return names[(std::size_t)token];
+    }
 
    private:
     Lexer::Token mToken;
+    Symbol mSymbol; /*!< Identifier or string literal, if the token has one */
+    mutable std::string mSymbolName;
 };
 
 class Type : public CFGNode {
-    void generate_first() {
-        for (unsigned t = (unsigned)Lexer::Token::KW_INT_32; t <= (unsigned)Lexer::Token::KW_VOID; ++t) {
-            first.insert(static_cast<Lexer::Token>(t));
-        }
-        first.insert(Lexer::Token::LBRACKET);
-    }
-
    public:
-    Type() : CFGNode(NodeKind::ERROR, "ERROR") {
-        generate_first();
-    }
+    Type() : CFGNode(NodeKind::ERROR, "ERROR") {}
 
     Type(std::unique_ptr<CFGNode>&& atomic_type) : CFGNode(NodeKind::TYPE, "TYPE") {
         addChildNode(std::move(atomic_type));
-
-        generate_first();
     }
 
     Type(std::unique_ptr<CFGNode>&& lbracket,
@@ -81,8 +91,6 @@ class Type : public CFGNode {
         addChildNode(std::move(int_literal));
         addChildNode(std::move(rbracket));
         addChildNode(std::move(type));
-
-        generate_first();
     }
 };
 
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace Crust {
+
+/*
+ * \class CorpusGenerator
+ * \brief Writes large, syntactically valid Crust programs of a chosen shape
+ *
+ * The programs follow the grammar Parser accepts, so the whole front end runs on them without
+ * reporting errors. Output is written one top level declaration at a time and only depends on the
+ * options: the random numbers come from a splitmix64 sequence over the seed rather than from the
+ * standard distributions, whose results differ between standard libraries.
+ *
+ * The depth option sets how far each declaration stretches its shape: the nesting level for NESTING,
+ * and the length of the elif chain, of the declaration list or of the expression for the others.
+ */
+class CorpusGenerator {
+   public:
+    enum class Shape {
+        FUNCTIONS,    /*!< Many small functions with short bodies */
+        CONDITIONALS, /*!< Functions holding one if with depth elif blocks and an else */
+        DECLARATIONS, /*!< Top level declarations of depth variables each */
+        EXPRESSIONS,  /*!< Functions assigning expressions of depth operands */
+        NESTING,      /*!< Functions whose segments nest depth levels deep */
+        MIXED,        /*!< A random mix of the other shapes, with depths up to depth */
+    };
+
+    struct Options {
+        Shape shape = Shape::MIXED;
+        std::uint64_t size = 1 << 20; /*!< Bytes to write, the last declaration may run past it */
+        unsigned depth = 4;
+        std::uint64_t seed = 0;
+    };
+
+    explicit CorpusGenerator(const Options& options);
+
+    // Writes the whole program to out and returns the number of bytes written
+    std::uint64_t generate(std::ostream& out);
+    std::string generate();
+
+    // Shapes are named by their lowercase enumerator, "functions" to "mixed"
+    static std::optional<Shape> parseShape(std::string_view name);
+    static std::string_view getShapeName(Shape shape);
+
+   private:
+    std::uint64_t random();
+    // Uniform in [0, bound), bound must not be 0
+    std::uint64_t below(std::uint64_t bound);
+    bool chance(unsigned percent) { return below(100) < percent; }
+
+    void declaration(Shape shape, unsigned depth);
+    void variableDeclaration(unsigned count);
+    void functionDeclaration(Shape shape, unsigned depth);
+
+    void statements(unsigned count, unsigned depth);
+    void statement(unsigned depth);
+    void conditional(unsigned elifs, unsigned depth);
+    void nested(unsigned depth);
+    void segment(unsigned count, unsigned depth);
+
+    void expression(unsigned operands, unsigned depth);
+    void term(unsigned depth);
+    // A loop range bound, the range of a for loop takes no string literals
+    void bound();
+    void type();
+    void variable();
+    void function();
+
+    void openLine();
+    void closeLine(std::string_view text);
+
+   private:
+    Options mOptions;
+    std::uint64_t mState;
+
+    std::string mBuffer;         /*!< Text of the declaration being generated */
+    unsigned mIndent = 0;
+    std::uint64_t mFunctions = 0; /*!< Functions declared so far, calls only target these */
+};
+
+}  // namespace Crust
@@ -5,7 +5,11 @@
 #include <unordered_map>
 
 namespace Crust {
+class GlobalLocation;
+class SourceBuffer;
 class SourceLocation;
+class SourceManager;
+struct LineColumn;
 
 /*
  * \class ErrorLogger
@@ -16,6 +20,7 @@ class ErrorLogger {
     enum class ErrorType : unsigned int {
         // Symbol
         INVALID_SYMBOL,
+        INVALID_UTF8,
 
         // Array
         ARRAY_EMPTY_EXPR,
@@ -68,6 +73,7 @@ class ErrorLogger {
         NEW_LINE_IN_LITERAL,
         MISSING_CLOSING_QUOTE,
         NUMBER_BAD_SUFFIX,
+        NUMBER_OUT_OF_RANGE,
 
         // Param
         PARAM_MISSING_NAME,
@@ -115,7 +121,10 @@ class ErrorLogger {
    public:
     static void printError(ErrorType eType);
 
-    static void printErrorAtLocation(ErrorType eType, const SourceLocation& srcLoc);
+    static void printErrorAtLocation(ErrorType eType, const SourceBuffer& source, const SourceLocation& srcLoc);
+    static void printErrorAtLocation(ErrorType eType, const LineColumn& position);
+    // Names the file as well, for programs made of several files
+    static void printErrorAtLocation(ErrorType eType, const SourceManager& sources, const GlobalLocation& srcLoc);
 
    private:
     ErrorLogger() = default;
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+
+namespace Crust {
+
+/*
+ * \class Generator
+ * \brief Lazy input range over the values a coroutine yields, a subset of C++23's std::generator
+ *
+ * The coroutine runs up to its first co_yield when iteration begins, and on to the next one on every
+ * increment. Yielded values are not copied: iterators point at the operand of the co_yield, which
+ * lives in the coroutine frame until the coroutine resumes. The frame is the only allocation.
+ * Exceptions thrown by the coroutine propagate out of begin() or operator++.
+ */
+template <typename T>
+class Generator : public std::ranges::view_interface<Generator<T>> {
+   public:
+    class promise_type {
+       public:
+        Generator get_return_object() { return Generator(Handle::from_promise(*this)); }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        std::suspend_always yield_value(const T& value) noexcept {
+            mValue = std::addressof(value);
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() { mException = std::current_exception(); }
+
+        // Generators only yield
+        template <typename U>
+        std::suspend_never await_transform(U&&) = delete;
+
+       private:
+        friend class Generator;
+
+        const T* mValue = nullptr;   /*!< Operand of the co_yield the coroutine is suspended at */
+        std::exception_ptr mException;
+    };
+
+    class Iterator {
+       public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        const T& operator*() const { return *mHandle.promise().mValue; }
+        const T* operator->() const { return mHandle.promise().mValue; }
+
+        Iterator& operator++() {
+            resume(mHandle);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return !mHandle or mHandle.done(); }
+
+       private:
+        friend class Generator;
+
+        explicit Iterator(std::coroutine_handle<promise_type> handle) : mHandle{handle} {}
+
+        std::coroutine_handle<promise_type> mHandle;
+    };
+
+   public:
+    Generator() = default;
+    Generator(Generator&& other) noexcept : mHandle{std::exchange(other.mHandle, {})} {}
+    Generator& operator=(Generator other) noexcept {
+        std::swap(mHandle, other.mHandle);
+        return *this;
+    }
+    ~Generator() {
+        if (mHandle)
+            mHandle.destroy();
+    }
+
+    // Starts the coroutine, only call once
+    Iterator begin() {
+        if (mHandle)
+            resume(mHandle);
+        return Iterator(mHandle);
+    }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+   private:
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Generator(Handle handle) : mHandle{handle} {}
+
+    static void resume(Handle handle) {
+        handle.resume();
+        if (handle.promise().mException)
+            std::rethrow_exception(std::exchange(handle.promise().mException, nullptr));
+    }
+
+   private:
+    Handle mHandle;
+};
+
+}  // namespace Crust
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <common/sourceloc.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Crust {
+
+/*
+ * \class SourceBuffer
+ * \brief Read-only bytes of a source file
+ *
+ * Regular files are memory-mapped so that the lexer can scan them without copying. Anything that
+ * cannot be mapped (pipes, character devices, ...) is read once into an owned buffer instead.
+ *
+ * Locations into the buffer are plain byte offsets. The first time one has to be shown to the user,
+ * the offsets of all line starts are collected in one vectorized pass and every lookup after that
+ * is a binary search.
+ */
+class SourceBuffer {
+   public:
+    static std::shared_ptr<const SourceBuffer> fromFile(const std::string& filename);
+    static std::shared_ptr<const SourceBuffer> fromFileDescriptor(int fd, const std::string& name);
+    static std::shared_ptr<const SourceBuffer> fromString(std::string contents, const std::string& name = "<string>");
+    // A copy of the bytes of buffer with [offset, offset + length) replaced by text. Buffers are never
+    // written to, whoever still holds buffer keeps reading the old bytes
+    static std::shared_ptr<const SourceBuffer> edit(const SourceBuffer& buffer, std::size_t offset, std::size_t length,
+                                                    std::string_view text);
+
+    ~SourceBuffer();
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+   public:
+    std::string_view getContents() const { return mContents; }
+    const std::string& getName() const { return mName; }
+    std::size_t getSize() const { return mContents.size(); }
+    bool isMapped() const { return mMapping != nullptr; }
+
+    LineColumn getLineColumn(SourceLocation location) const;
+    std::size_t getLineCount() const { return getLineStarts().size(); }
+
+   private:
+    friend class SourceManager;
+
+    explicit SourceBuffer(const std::string& name) : mName{name} {}
+
+    // Bytes owned by owner, which the buffer keeps alive
+    static std::shared_ptr<const SourceBuffer> fromView(std::string_view contents, const std::string& name, std::shared_ptr<const void> owner);
+
+    const std::vector<std::uint64_t>& getLineStarts() const;
+
+   private:
+    std::string mName;                  /*!< Name of the file the buffer was loaded from */
+    std::string mStorage;               /*!< Owned bytes, used when the source could not be mapped */
+    void* mMapping = nullptr;           /*!< Start of the read-only mapping, if any */
+    std::size_t mMappingSize{0};        /*!< Size of the mapping in bytes */
+    std::shared_ptr<const void> mOwner; /*!< Keeps the bytes of a view alive */
+    std::string_view mContents;         /*!< The source bytes, either mapped, owned or viewed */
+
+    mutable std::once_flag mLineStartsBuilt;
+    mutable std::vector<std::uint64_t> mLineStarts; /*!< Offset of the first byte of every line, built on first use */
+};
+
+}  // namespace Crust
@@ -1,19 +1,57 @@
 #pragma once
 
+#include <cstdint>
+
 namespace Crust {
+
+/*
+ * \class SourceLocation
+ * \brief Byte offset into a SourceBuffer
+ *
+ * Lines and columns are only needed to report errors, so they are not tracked while lexing:
+ * SourceBuffer::getLineColumn resolves an offset on demand.
+ */
 class SourceLocation {
    public:
-    SourceLocation() : mCurrentLine{0}, mCurrentColumn{0} {}
+    SourceLocation() : mOffset{0} {}
+
+    explicit SourceLocation(std::uint64_t offset) : mOffset{offset} {}
+
+    std::uint64_t getOffset() const { return mOffset; }
+
+    bool operator==(const SourceLocation&) const = default;
+
+   private:
+    std::uint64_t mOffset; /*!< Offset in bytes from the start of the buffer */
+};
+
+/*
+ * \class GlobalLocation
+ * \brief 32-bit offset into the address space of a SourceManager
+ *
+ * Every file of a SourceManager covers its own range of offsets, so the offset alone tells the file
+ * a location is in as well as the position in it. See SourceManager::getGlobalLocation.
+ */
+class GlobalLocation {
+   public:
+    static constexpr std::uint32_t INVALID = 0xffffffff;
+
+    constexpr GlobalLocation() : mOffset{INVALID} {}
+    constexpr explicit GlobalLocation(std::uint32_t offset) : mOffset{offset} {}
 
-    SourceLocation(const unsigned line, const unsigned column) : mCurrentLine{line}, mCurrentColumn{column} {}
+    constexpr std::uint32_t getOffset() const { return mOffset; }
+    constexpr bool isValid() const { return mOffset != INVALID; }
 
-    void init();
-    void advance(bool nextLine = false);
-    unsigned getCurrentColumn() const { return mCurrentColumn; }
-    unsigned getCurrentLine() const { return mCurrentLine; }
+    constexpr bool operator==(const GlobalLocation&) const = default;
 
    private:
-    unsigned mCurrentLine;   /*!< Current line in the file the lexer is at */
-    unsigned mCurrentColumn; /*!< Current column in the file the lexer is at */
+    std::uint32_t mOffset;
 };
-}  // namespace Crust
\ No newline at end of file
+
+// A SourceLocation resolved against its buffer, both counted from 1
+struct LineColumn {
+    unsigned line;
+    unsigned column;
+};
+
+}  // namespace Crust
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <common/sourcebuffer.hpp>
+#include <common/sourceloc.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Crust {
+
+/*
+ * \class FileID
+ * \brief Index of a file in a SourceManager
+ */
+class FileID {
+   public:
+    static constexpr std::uint32_t INVALID = 0xffffffff;
+
+    constexpr FileID() : mId{INVALID} {}
+    constexpr explicit FileID(std::uint32_t id) : mId{id} {}
+
+    constexpr std::uint32_t getId() const { return mId; }
+    constexpr bool isValid() const { return mId != INVALID; }
+
+    constexpr bool operator==(const FileID&) const = default;
+
+   private:
+    std::uint32_t mId;
+};
+
+/*
+ * \class SourceManager
+ * \brief Owns the sources of a program made of several files
+ *
+ * Every file gets a FileID and a range of a 32-bit address space, so that a GlobalLocation is a
+ * single offset. The address space is backed by one arena of reserved virtual memory: regular files
+ * are mapped into it at the start of their range, and anything that cannot be mapped is copied into
+ * anonymous pages there. The bytes of a file are thus found at arena + offset, and a location is
+ * resolved with a binary search over the file bases followed by one over the lines of the file.
+ *
+ * Ranges start on page boundaries and leave room for the end of file location, so the files of a
+ * manager can hold up to 4 GiB in total. Where no arena can be reserved, files are loaded as plain
+ * SourceBuffers and still get their ranges. Adding files is not thread-safe; lookups are.
+ */
+class SourceManager {
+   public:
+    SourceManager();
+    ~SourceManager() = default;
+
+    SourceManager(const SourceManager&) = delete;
+    SourceManager& operator=(const SourceManager&) = delete;
+
+    // Return an invalid FileID if the source cannot be read or does not fit in the address space
+    FileID addFile(const std::string& filename);
+    FileID addFileDescriptor(int fd, const std::string& name);
+    FileID addString(std::string_view contents, const std::string& name = "<string>");
+
+    std::size_t getFileCount() const { return mBuffers.size(); }
+
+    // The buffer stays valid after the manager is destroyed
+    const std::shared_ptr<const SourceBuffer>& getBuffer(FileID file) const { return mBuffers[file.getId()]; }
+    const std::string& getName(FileID file) const { return getBuffer(file)->getName(); }
+
+    // True if the files are laid out in a single arena
+    bool hasArena() const { return mArena != nullptr; }
+
+   public:
+    GlobalLocation getGlobalLocation(FileID file, SourceLocation location) const {
+        return GlobalLocation(mBases[file.getId()] + (std::uint32_t)location.getOffset());
+    }
+
+    // File of a location, or an invalid FileID if no file covers it
+    FileID getFileID(GlobalLocation location) const;
+
+    // For locations returned by getGlobalLocation, nothing if no file covers the location
+    std::optional<SourceLocation> getLocalLocation(GlobalLocation location) const;
+    std::optional<LineColumn> getLineColumn(GlobalLocation location) const;
+
+   private:
+    // Start of the range for a file of size bytes, if it still fits
+    std::optional<std::uint32_t> allocate(std::uint64_t size) const;
+    FileID addBuffer(std::uint32_t base, std::uint64_t size, std::shared_ptr<const SourceBuffer> buffer);
+
+    // Copies contents to the arena at base
+    std::shared_ptr<const SourceBuffer> copyToArena(std::uint32_t base, std::string_view contents, const std::string& name);
+
+   private:
+    std::shared_ptr<char> mArena; /*!< Start of the reserved address space, unmapped with its last user */
+    std::size_t mPageSize;
+
+    std::vector<std::uint32_t> mBases; /*!< Start of the range of every file, increasing */
+    std::vector<std::shared_ptr<const SourceBuffer>> mBuffers;
+    std::uint64_t mEnd = 0; /*!< End of the last range */
+};
+
+}  // namespace Crust
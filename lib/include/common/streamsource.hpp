@@ -0,0 +1,78 @@
+#pragma once
+
+#include <common/sourceloc.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+
+namespace Crust {
+
+/*
+ * \class StreamSource
+ * \brief Fixed-size window over an input that is read as it is lexed
+ *
+ * Used for pipes and inputs too large to map. The window holds the bytes from the token being
+ * lexed to the end of what has been read so far; refill() drops everything before that token,
+ * moves the rest to the front and reads more, so a token cut by the end of one read is completed by
+ * the next. Memory does not depend on the size of the input: the window only grows when a single
+ * token is longer than it, and then to the size of that token. Comments and the bytes skipped by an
+ * error recovery are dropped window by window and never grow it.
+ *
+ * Offsets are 64-bit and count from the start of the input. Lines are counted as bytes are
+ * dropped, so locations at or after the start of the window can always be resolved.
+ */
+class StreamSource {
+   public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 1 << 20;
+
+    // Reads up to size bytes into buffer and returns how many were read, 0 at the end of the input
+    using Reader = std::function<std::size_t(char* buffer, std::size_t size)>;
+
+    // The stream must outlive the source
+    static std::shared_ptr<StreamSource> fromStream(std::istream& stream, const std::string& name = "<stream>",
+                                                    std::size_t capacity = DEFAULT_CAPACITY);
+    // The descriptor is not closed by the source
+    static std::shared_ptr<StreamSource> fromFileDescriptor(int fd, const std::string& name = "<fd>",
+                                                            std::size_t capacity = DEFAULT_CAPACITY);
+
+    StreamSource(Reader reader, const std::string& name, std::size_t capacity = DEFAULT_CAPACITY);
+
+    StreamSource(const StreamSource&) = delete;
+    StreamSource& operator=(const StreamSource&) = delete;
+
+   public:
+    const char* data() const { return mBuffer.get(); }
+    std::size_t size() const { return mSize; }
+    std::size_t getCapacity() const { return mCapacity; }
+    const std::string& getName() const { return mName; }
+
+    // Offset in the input of data()
+    std::uint64_t getOffset() const { return mOffset; }
+
+    // True once the whole input is in the window
+    bool isExhausted() const { return mExhausted; }
+
+    // Drops the bytes before keep, which must point into the window, and reads more input
+    void refill(const char* keep);
+
+    // Line and column of a location at or after getOffset()
+    LineColumn getLineColumn(SourceLocation location) const;
+
+   private:
+    Reader mReader;
+    std::string mName;
+
+    std::unique_ptr<char[]> mBuffer;
+    std::size_t mCapacity;
+    std::size_t mSize = 0;
+    std::uint64_t mOffset = 0;
+    bool mExhausted = false;
+
+    std::uint64_t mLine = 1;          /*!< Line of the first byte of the window */
+    std::uint64_t mLineStart = 0;     /*!< Offset in the input where that line starts */
+};
+
+}  // namespace Crust
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace Crust {
+
+/*
+ * \class Symbol
+ * \brief 32-bit handle to a string interned in a SymbolPool
+ *
+ * Two symbols from the same pool are equal exactly when their strings are.
+ */
+class Symbol {
+   public:
+    static constexpr std::uint32_t INVALID = std::numeric_limits<std::uint32_t>::max();
+
+    constexpr Symbol() : mId{INVALID} {}
+    constexpr explicit Symbol(std::uint32_t id) : mId{id} {}
+
+    constexpr std::uint32_t getId() const { return mId; }
+    constexpr bool isValid() const { return mId != INVALID; }
+
+    constexpr bool operator==(const Symbol&) const = default;
+
+   private:
+    std::uint32_t mId;
+};
+
+/*
+ * \class SymbolPool
+ * \brief Interns identifiers and string literals
+ *
+ * Strings are copied once into large arena blocks and looked up through an open-addressing hash
+ * table, so interning a string that is already known allocates nothing. Views returned by get()
+ * stay valid for the lifetime of the pool. A pool is not thread-safe.
+ */
+class SymbolPool {
+   public:
+    SymbolPool();
+
+    SymbolPool(const SymbolPool&) = delete;
+    SymbolPool& operator=(const SymbolPool&) = delete;
+
+    // The pool the lexer interns into
+    static SymbolPool& global();
+
+   public:
+    Symbol intern(std::string_view text) { return intern(text, hash(text)); }
+    // For text hashed ahead of time with hash(), e.g. on another thread
+    Symbol intern(std::string_view text, std::uint32_t textHash);
+    std::string_view get(Symbol symbol) const { return mStrings[symbol.getId()]; }
+    std::size_t size() const { return mStrings.size(); }
+
+    static std::uint32_t hash(std::string_view text);
+
+   private:
+    const char* store(std::string_view text);
+    void grow();
+
+   private:
+    static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> mBlocks; /*!< Arena holding the bytes of every string */
+    char* mBlockIt = nullptr;                     /*!< Free space left in the last block */
+    std::size_t mBlockLeft = 0;
+
+    std::vector<std::string_view> mStrings; /*!< Text of every symbol, indexed by id */
+    std::vector<std::uint32_t> mHashes;     /*!< Hash of every symbol, indexed by id */
+    std::vector<std::uint32_t> mSlots;      /*!< Open-addressing table of ids, Symbol::INVALID when empty */
+};
+
+}  // namespace Crust
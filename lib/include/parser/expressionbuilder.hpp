@@ -0,0 +1,95 @@
+#pragma once
+
+#include <CFG/cfg.hpp>
+#include <CFG/expressions.hpp>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <parser/lexer.hpp>
+#include <utility>
+
+namespace Crust {
+
+/*
+ * \class ExpressionBuilder
+ * \brief Folds the terms of an expression and the binary operators between them into BINARY_EXPRESSION
+ * nodes, by precedence
+ *
+ * Operands and operators are pushed in source order. An operator first folds the pending operators
+ * that bind at least as tightly as itself, which makes every operator left associative, then waits
+ * for its right operand. This is the loop of a Pratt parser with the recursion on the right operand
+ * kept in mPending instead of on the call stack: the pending operators bind strictly tighter from
+ * bottom to top, so there are never more of them than precedence levels, however long the
+ * expression is.
+ */
+class ExpressionBuilder {
+   public:
+    static constexpr unsigned MAX_POWER = 6;
+
+    // Binding power of a binary operator, higher binds tighter, 0 for any other token
+    static constexpr unsigned bindingPower(Lexer::Token token) {
+        switch (token) {
+            case Lexer::Token::OP_OR:
+                return 1;
+            case Lexer::Token::OP_AND:
+                return 2;
+            case Lexer::Token::OP_EQ:
+            case Lexer::Token::OP_NE:
+                return 3;
+            case Lexer::Token::OP_GT:
+            case Lexer::Token::OP_GE:
+            case Lexer::Token::OP_LE:
+            case Lexer::Token::OP_LT:
+                return 4;
+            case Lexer::Token::OP_PLUS:
+            case Lexer::Token::OP_MINUS:
+                return 5;
+            case Lexer::Token::OP_MULT:
+            case Lexer::Token::OP_DIV:
+            case Lexer::Token::OP_MOD:
+                return MAX_POWER;
+            default:
+                return 0;
+        }
+    }
+
+    // The first term, then the term after every operator
+    void pushOperand(std::unique_ptr<CFGNode>&& operand) { mOperand = std::move(operand); }
+
+    // op is the TOKEN node of token, a binary operator
+    void pushOperator(Lexer::Token token, std::unique_ptr<CFGNode>&& op) {
+        const unsigned power = bindingPower(token);
+        assert(power > 0);
+        fold(power);
+        mPending[mNumPending++] = {std::move(mOperand), std::move(op), power};
+    }
+
+    // The whole expression, the builder is left empty
+    std::unique_ptr<CFGNode> finish() {
+        fold(1);
+        return std::move(mOperand);
+    }
+
+   private:
+    // Folds the pending operators that bind at least with power into mOperand
+    void fold(unsigned power) {
+        while (mNumPending > 0 and mPending[mNumPending - 1].power >= power) {
+            Pending& pending = mPending[--mNumPending];
+            mOperand = std::make_unique<BinaryExpression>(std::move(pending.lhs), std::move(pending.op), std::move(mOperand));
+        }
+    }
+
+   private:
+    struct Pending {
+        std::unique_ptr<CFGNode> lhs;
+        std::unique_ptr<CFGNode> op;
+        unsigned power = 0;
+    };
+
+    std::array<Pending, MAX_POWER> mPending;
+    std::size_t mNumPending = 0;
+    std::unique_ptr<CFGNode> mOperand; /*!< Right operand of the topmost pending operator */
+};
+
+}  // namespace Crust
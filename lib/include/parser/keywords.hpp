@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <parser/lexer.hpp>
+#include <string_view>
+
+namespace Crust {
+
+/*
+ * \class Keywords
+ * \brief Compile-time perfect hash over the reserved words of the language
+ *
+ * The reserved words are the Lexer::Token range [KW_INT_32, KW_RETURN] plus the word operators
+ * 'and' and 'or'. A word is hashed from its length, first and last character into a 64 slot table
+ * whose multiplier is searched at compile time, so classifying a word costs one hash, one table
+ * load and at most one string comparison.
+ */
+class Keywords {
+   public:
+    struct Keyword {
+        std::string_view spelling;
+        Lexer::Token token;
+    };
+
+    static constexpr std::size_t FIRST = (std::size_t)Lexer::Token::KW_INT_32;
+    static constexpr std::size_t LAST = (std::size_t)Lexer::Token::KW_RETURN;
+    static constexpr std::size_t COUNT = LAST - FIRST + 3;
+
+    // Spellings of the keyword range, in the order of Lexer::Token
+    static constexpr std::array<std::string_view, LAST - FIRST + 1> spellings = {
+        "i32", "i64", "u32", "u64", "f32", "f64", "string", "bool", "void", "true", "false",
+        "let",
+        "if", "elif", "else",
+        "for", "in", "while",
+        "fn", "return"};
+
+    static const std::array<Keyword, COUNT> all;
+
+    // Returns the keyword token spelled by word, or IDENTIFIER
+    static constexpr Lexer::Token classify(std::string_view word);
+
+   private:
+    static constexpr std::size_t TABLE_SIZE = 64;
+
+    using Table = std::array<Keyword, TABLE_SIZE>;
+
+    static constexpr std::array<Keyword, COUNT> makeAll();
+    static constexpr std::size_t hash(std::string_view word, std::uint32_t multiplier);
+    static constexpr bool isPerfect(std::uint32_t multiplier);
+    static constexpr std::uint32_t findSeed();
+    static constexpr Table makeTable(std::uint32_t seed);
+
+    static const std::uint32_t mSeed;
+    static const std::size_t mMinLength;
+    static const std::size_t mMaxLength;
+    static const Table mTable; /*!< Slot hash(word) holds the keyword hashing there, or an empty spelling */
+};
+
+constexpr std::array<Keywords::Keyword, Keywords::COUNT> Keywords::makeAll() {
+    std::array<Keyword, COUNT> keywords{};
+    for (std::size_t i = 0; i < spellings.size(); ++i)
+        keywords[i] = {spellings[i], static_cast<Lexer::Token>(FIRST + i)};
+    keywords[COUNT - 2] = {"and", Lexer::Token::OP_AND};
+    keywords[COUNT - 1] = {"or", Lexer::Token::OP_OR};
+    return keywords;
+}
+
+inline constexpr std::array<Keywords::Keyword, Keywords::COUNT> Keywords::all = Keywords::makeAll();
+
+constexpr std::size_t Keywords::hash(std::string_view word, std::uint32_t multiplier) {
+    const std::uint32_t key = (std::uint32_t)(unsigned char)word.front() |
+                              (std::uint32_t)(unsigned char)word.back() << 8 |
+                              (std::uint32_t)word.size() << 16;
+    return (key * multiplier) >> 26;
+}
+
+constexpr bool Keywords::isPerfect(std::uint32_t multiplier) {
+    std::array<bool, TABLE_SIZE> used{};
+    for (const auto& keyword : all) {
+        const std::size_t slot = hash(keyword.spelling, multiplier);
+        if (used[slot])
+            return false;
+        used[slot] = true;
+    }
+    return true;
+}
+
+constexpr std::uint32_t Keywords::findSeed() {
+    // Odd multipliers only, starting from the 32-bit golden ratio
+    for (std::uint32_t multiplier = 0x9E3779B1u; multiplier != 0x9E3779B1u + 2 * 100000; multiplier += 2)
+        if (isPerfect(multiplier))
+            return multiplier;
+
+    // Reached only when the keyword set changes, and fails the constant evaluation of mSeed
+    throw "No perfect hash found for the keyword set, widen the search or grow TABLE_SIZE";
+}
+
+inline constexpr std::uint32_t Keywords::mSeed = Keywords::findSeed();
+
+constexpr Keywords::Table Keywords::makeTable(std::uint32_t seed) {
+    Table slots{};
+    for (auto& slot : slots) slot = {"", Lexer::Token::IDENTIFIER};
+    for (const auto& keyword : all) slots[hash(keyword.spelling, seed)] = keyword;
+    return slots;
+}
+
+inline constexpr Keywords::Table Keywords::mTable = Keywords::makeTable(Keywords::mSeed);
+
+inline constexpr std::size_t Keywords::mMinLength = [] {
+    std::size_t length = Keywords::all[0].spelling.size();
+    for (const auto& keyword : Keywords::all)
+        if (keyword.spelling.size() < length)
+            length = keyword.spelling.size();
+    return length;
+}();
+
+inline constexpr std::size_t Keywords::mMaxLength = [] {
+    std::size_t length = 0;
+    for (const auto& keyword : Keywords::all)
+        if (keyword.spelling.size() > length)
+            length = keyword.spelling.size();
+    return length;
+}();
+
+constexpr Lexer::Token Keywords::classify(std::string_view word) {
+    // Empty slots hold an empty spelling, which never compares equal to a word of mMinLength or more
+    if (word.size() < mMinLength or word.size() > mMaxLength)
+        return Lexer::Token::IDENTIFIER;
+
+    const Keyword& slot = mTable[hash(word, mSeed)];
+    return slot.spelling == word ? slot.token : Lexer::Token::IDENTIFIER;
+}
+
+}  // namespace Crust
@@ -1,18 +1,39 @@
 #pragma once
 #include <array>
+#include <common/errorlogger.hpp>
+#include <common/sourcebuffer.hpp>
 #include <common/sourceloc.hpp>
+#include <common/streamsource.hpp>
+#include <common/symbolpool.hpp>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace Crust {
+class TokenTable;
+
 class Lexer {
    private:
     // Common::Type mCurrentType; /*!< Current type recognized by the lexer */
-    SourceLocation mSrcLoc; /*!< Information about the current location of the lexer in the file */
-    int mCurrentInt;
-    float mCurrentFloat;
-    std::string mCurrentStr;
-    std::string mBuffer;                   /*!< The lexer buffer */
-    std::string::const_iterator mBufferIt; /*!< Iterator of the lexer buffer */
+    std::uint64_t mCurrentInt; /*!< Value of the last integer literal, 0 when out of range */
+    double mCurrentFloat;      /*!< Value of the last float literal, 0 when out of range */
+    std::string_view mCurrentStr;                /*!< Text of the last identifier or string literal, points into mBuffer */
+    Symbol mCurrentSymbol;                       /*!< mCurrentStr interned in SymbolPool::global() */
+    std::shared_ptr<const SourceBuffer> mSource; /*!< Keeps the bytes behind mBuffer alive */
+    std::shared_ptr<StreamSource> mStream;       /*!< Input read window by window, used instead of mSource */
+    std::string_view mBuffer;                    /*!< The lexer buffer, or the current window of mStream */
+    const char* mBufferIt;                       /*!< Iterator of the lexer buffer */
+    const char* mBufferEnd;                      /*!< One past the last byte of the lexer buffer */
+    const char* mTokenIt;                        /*!< Start of the last token returned */
+    std::uint64_t mBufferOffset;                 /*!< Offset in the input of mBuffer.data() */
+    std::uint64_t mTokenOffset;                  /*!< Offset in the input of the last token returned */
+
+    std::optional<ErrorLogger::ErrorType> mPendingError; /*!< Reported once the token it belongs to is complete */
+    SourceLocation mPendingErrorLocation;
+    char mRecoveryEnd; /*!< Byte an error recovery ran out of window looking for, 0 when none */
+    bool mSpeculative; /*!< Lexing a chunk for lexAllParallel: nothing is interned and errors stay pending */
 
    public:
     enum class Token : unsigned {
@@ -100,26 +121,126 @@ class Lexer {
 
     const static std::array<std::string, (size_t)Token::UNKNOWN + 1> token_to_str;
 
+    // How getNextTokenAndComment recognizes tokens, both produce exactly the same tokens
+    enum class Backend : unsigned {
+        HANDWRITTEN, /*!< A switch on the first character of the token */
+        DFA          /*!< Tables generated from spec/tokens.g, see lib/src/parser/dfalexer.cpp */
+    };
+
+    /*
+     * \class Checkpoint
+     * \brief Position and payload of a lexer, for lookahead and backtracking
+     *
+     * Saving and restoring copy a few words and never touch the source. A stream lexer can only be
+     * restored while the checkpoint is still in its window.
+     */
+    class Checkpoint {
+       private:
+        friend class Lexer;
+
+        std::uint64_t mLocation;    /*!< GetCurrentLocation() when saved */
+        std::uint64_t mTokenOffset;
+        std::uint64_t mInt;
+        double mFloat;
+        std::string_view mStr;
+        Symbol mSymbol;
+    };
+
+    // Replaces length bytes at offset with text
+    struct TextEdit {
+        std::size_t offset;
+        std::size_t length;
+        std::string_view text;
+    };
+
     Lexer()
-        : mCurrentInt{0}, mCurrentFloat{0.0f} {};
+        : mCurrentInt{0}, mCurrentFloat{0.0}, mBufferIt{nullptr}, mBufferEnd{nullptr}, mTokenIt{nullptr}, mBufferOffset{0}, mTokenOffset{0}, mRecoveryEnd{0}, mSpeculative{false}, mBackend{Backend::HANDWRITTEN} {};
 
     bool init(const std::string& filename);
+    bool init(std::shared_ptr<const SourceBuffer> source);
+    // Copies of a lexer share its stream, only one of them may keep lexing
+    bool init(std::shared_ptr<StreamSource> stream);
+
+    void setBackend(Backend backend) { mBackend = backend; }
+    Backend getBackend() const { return mBackend; }
 
     Token getNextTokenAndComment();
     Token getNextToken();
 
+    Checkpoint save() const;
+    void restore(const Checkpoint& checkpoint);
+
+    TokenTable lexAll(bool keepComments = false);
+    // Same tokens and diagnostics as lexAll, with chunks of at least minChunkSize bytes lexed on up to threads threads
+    TokenTable lexAllParallel(unsigned threads, bool keepComments = false, std::size_t minChunkSize = 1 << 16);
+    // Applies edit to the source of tokens, made by lexAll(keepComments), and updates them in place by relexing
+    // only around the edit. The lexer is left at the end of the edited source. False if edit is out of range
+    bool relex(TokenTable& tokens, const TextEdit& edit, bool keepComments = false);
+
     //  Common::Type GetCurrentType() const { return mCurrentType; }
 
-    const SourceLocation GetCurrentLocation() const { return mSrcLoc; }
+    // Location just past the last token
+    const SourceLocation GetCurrentLocation() const { return SourceLocation(mBufferOffset + (mBufferIt - mBuffer.data())); }
+    LineColumn getLineColumn(SourceLocation location) const;
+    // Null when lexing a stream
+    const std::shared_ptr<const SourceBuffer>& getSourceBuffer() const { return mSource; }
 
-    int getCurrentInt() const { return mCurrentInt; }
-    float getCurrentFloat() const { return mCurrentFloat; }
+    std::uint64_t getCurrentInt() const { return mCurrentInt; }
+    double getCurrentFloat() const { return mCurrentFloat; }
 
-    const std::string& getCurrentStr() const { return mCurrentStr; }
+    // When lexing a stream, only valid until the next token is read
+    std::string_view getCurrentStr() const { return mCurrentStr; }
+    Symbol getCurrentSymbol() const { return mCurrentSymbol; }
+
+    std::uint64_t getCurrentTokenOffset() const { return mTokenOffset; }
+    std::uint64_t getCurrentTokenLength() const { return GetCurrentLocation().getOffset() - mTokenOffset; }
 
    private:
+    friend class TokenPipeline;
+
+    // A token lexed without interning, to be emitted later in token order
+    struct SpeculativeToken {
+        Token kind;
+        std::uint64_t offset;
+        std::uint64_t length;
+        std::uint64_t value; /*!< Bits of the int or float payload, or SymbolPool::hash of the symbol text */
+    };
+
+    // A diagnostic held back until the token it belongs to is emitted
+    struct SpeculativeError {
+        std::size_t token; /*!< Index of the token in the tokens it was lexed with */
+        ErrorLogger::ErrorType type;
+        SourceLocation location;
+    };
+
+    struct Chunk;
+
+    Token lexHandwritten();
+    Token lexDfa();
+    Token lexBackend() { return mBackend == Backend::DFA ? lexDfa() : lexHandwritten(); }
+    // The identifier at mBufferIt, whose first code point is startLength bytes long
+    Token lexIdentifier(unsigned startLength);
     Token tokenizeCurrentStr();
+    void parseInt(const char* begin, const char* end);
+    void parseFloat(const char* begin, const char* end);
+    void internCurrentStr();
+    void reportError(ErrorLogger::ErrorType type);
+    void refillWindow(const char* keep);
     char advance();
+    char current() const { return mBufferIt == mBufferEnd ? 0 : *mBufferIt; }
+    void advanceTo(const char* target);
+    // Error recovery: skips past the next end byte, or to the end of the window and records it in mRecoveryEnd
+    void skipPast(char end);
+    void pushCurrentToken(TokenTable& tokens, Token token, bool keepComments);
+
+    SpeculativeToken takeToken(Token token) const;
+    // Symbol of an IDENTIFIER or STR_LITERAL, whose offset is into source
+    static Symbol internToken(const SpeculativeToken& token, std::string_view source);
+    void lexChunk(Chunk& chunk);
+    std::size_t relexChunk(const Chunk& chunk, const char*& resume, TokenTable& tokens, bool keepComments);
+    void emitToken(const SpeculativeToken& token, TokenTable& tokens, bool keepComments) const;
+
+    Backend mBackend; /*!< Recognizer used by getNextTokenAndComment */
 };
 
 }  // namespace Crust
@@ -3,25 +3,74 @@
 #include <CFG/cfg.hpp>
 #include <CFG/declarations.hpp>
 #include <CFG/expressions.hpp>
+#include <CFG/first.hpp>
 #include <CFG/misc.hpp>
 #include <CFG/statements.hpp>
+#include <array>
+#include <common/errorlogger.hpp>
 #include <memory>
 #include <parser/lexer.hpp>
+#include <parser/tokenpipeline.hpp>
+#include <parser/tokenview.hpp>
 
 namespace Crust {
+class TokenTable;
 
 class Parser {
    public:
     explicit Parser() : mCurrentToken{Lexer::Token::TOK_SOF} {}
     ~Parser() = default;  // Not optimal? Do I need to add the other 1/3
 
+    // How parseProgram parses, both build exactly the same tree and report the same errors
+    enum class Backend : unsigned {
+        HANDWRITTEN, /*!< Recursive descent, one function per rule */
+        TABLE        /*!< LL(1) tables generated from spec/grammar.g, see lib/src/parser/llparser.cpp */
+    };
+
     std::unique_ptr<CFGNode> parseProgram(const std::string& filename);
+    std::unique_ptr<CFGNode> parseProgram(const TokenTable& tokens);
+
+    void setBackend(Backend backend) { mBackend = backend; }
+    Backend getBackend() const { return mBackend; }
+
+    // When set, parseProgram(filename) lexes on a second thread through a TokenPipeline. The tree and
+    // the diagnostics are the same either way
+    void setPipelined(bool pipelined) { mPipelined = pipelined; }
+    bool isPipelined() const { return mPipelined; }
 
    private:
+    friend class ParserLookaheadTest;
+
+    // Records entering and leaving a rule in the Trace, does nothing unless built with CRUST_TRACE
+    class RuleTrace {
+       public:
+        RuleTrace(const Parser& parser, CFGNode::NodeKind rule);
+        ~RuleTrace();
+
+       private:
+        const Parser& mParser;
+        CFGNode::NodeKind mRule;
+    };
+
+    static constexpr std::size_t LOOKAHEAD = 4; /*!< Capacity of the lookahead ring, a power of two */
+
     void skipToNextSemiColon();
-    Lexer::Token peekNextToken();
+    // Reports error at every token up to one in expected, or TOK_EOF
+    void skipUntil(TokenSet expected, ErrorLogger::ErrorType error);
+    Lexer::Token nextToken();
+    // The k-th token after mCurrentToken, 1 being the next one, for 1 <= k <= LOOKAHEAD
+    Lexer::Token peek(std::size_t k);
+    LexedToken lexToken();
+    const SourceBuffer& currentSource() const;
+    SourceLocation currentLocation() const;
 
    private:
+    std::unique_ptr<CFGNode> parseBackend() {
+        return mBackend == Backend::TABLE ? parseProgramTable() : parseProgramDecl();
+    }
+    // Expands the rules on an explicit stack, driven by the generated tables
+    std::unique_ptr<CFGNode> parseProgramTable();
+
     std::unique_ptr<ProgDecl> parseProgramDecl();
 
     std::unique_ptr<DeclList> parseDeclList();
@@ -29,22 +78,18 @@ class Parser {
 
     std::unique_ptr<VarDecl> parseVarDecl();
     std::unique_ptr<VarDeclList> parseVarDeclList();
-    std::unique_ptr<VarDeclList_> parseVarDeclList_();
 
     std::unique_ptr<FnDecl> parseFnDecl();
     std::unique_ptr<FnParamList> parseFnParamList();
-    std::unique_ptr<FnParamList_> parseFnParamList_();
     std::unique_ptr<FnParam> parseFnParam();
 
     std::unique_ptr<Expression> parseExpression();
-    std::unique_ptr<ExpressionRHS> parseExpressionRHS();
 
     std::unique_ptr<Term> parseTerm();
     std::unique_ptr<FloatTerm> parseFloatTerm();
     std::unique_ptr<ArraySubscript> parseArraySubscript();
     std::unique_ptr<Call> parseCall();
     std::unique_ptr<CallParamList> parseCallParamList();
-    std::unique_ptr<CallParamList_> parseCallParamList_();
 
     std::unique_ptr<StmtList> parseStmtList();
     std::unique_ptr<Stmt> parseStmt();
@@ -67,11 +112,25 @@ class Parser {
     std::unique_ptr<ReturnVar> parseReturnVar();
 
     std::unique_ptr<Segment> parseSegment();
-    std::unique_ptr<Token> parseToken(Lexer::Token token);
+    std::unique_ptr<Token> parseToken(Lexer::Token token) { return parseToken(TokenSet{token}); }
+    // The current token if it is one of expected, otherwise reports it, skips it and returns nullptr
+    std::unique_ptr<Token> parseToken(TokenSet expected);
     std::unique_ptr<Type> parseType();
 
    private:
     Lexer mLexer;
     Lexer::Token mCurrentToken;
+    LexedToken mCurrent{}; /*!< Payload of mCurrentToken when reading from mLexer */
+
+    std::array<LexedToken, LOOKAHEAD> mLookahead{}; /*!< Ring of the tokens lexed past mCurrentToken by peek */
+    std::size_t mLookaheadBegin = 0;
+    std::size_t mLookaheadSize = 0;
+
+    const TokenTable* mTokens = nullptr; /*!< Pre-lexed token stream, consumed by index when set */
+    std::size_t mTokenIdx = 0;           /*!< Index of mCurrentToken in mTokens */
+
+    Backend mBackend = Backend::HANDWRITTEN;
+    bool mPipelined = false;
+    std::unique_ptr<TokenPipeline> mPipeline; /*!< Read instead of mLexer while parsing a file pipelined */
 };
 }  // namespace Crust
\ No newline at end of file
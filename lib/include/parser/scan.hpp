@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+
+namespace Crust {
+
+/*
+ * \class Scan
+ * \brief Vectorized scanning kernels used by the lexer's hot loops
+ *
+ * Every kernel has a scalar, an SSE2 and an AVX2 implementation. The fastest one supported by the
+ * running CPU is picked on first use; all of them return exactly the same result. Until then the
+ * kernels are constant-initialized ones that pick, so lexing from a static initializer is fine.
+ */
+class Scan {
+   public:
+    enum class Isa : unsigned {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    Scan() = delete;
+
+   public:
+    // First byte in [it, end) that is not isspace() in the C locale, or end
+    static const char* skipWhitespace(const char* it, const char* end) { return kernels().skipWhitespace(it, end); }
+
+    // First '\n' in [it, end), or end
+    static const char* findNewline(const char* it, const char* end) { return kernels().findNewline(it, end); }
+
+    // First '"', '\n' or '\0' in [it, end), or end
+    static const char* findStringEnd(const char* it, const char* end) { return kernels().findStringEnd(it, end); }
+
+    // First byte >= 0x80 in [it, end), or end
+    static const char* findNonAscii(const char* it, const char* end) { return kernels().findNonAscii(it, end); }
+
+    // Picks the kernels if nothing was scanned yet
+    static Isa getIsa();
+    static bool isSupported(Isa isa);
+
+    // Forces a specific implementation, returns false if the CPU does not support it. Meant for tests
+    // and benchmarks: lexers running on other threads meanwhile switch between two calls
+    static bool setIsa(Isa isa);
+
+   private:
+    using Kernel = const char* (*)(const char*, const char*);
+
+    struct Kernels {
+        Isa isa;
+        Kernel skipWhitespace;
+        Kernel findNewline;
+        Kernel findStringEnd;
+        Kernel findNonAscii;
+    };
+
+    static const Kernels& kernels() { return *mKernels.load(std::memory_order_relaxed); }
+    static const Kernels* select(Isa isa);
+    static Isa detect();
+
+    static const Kernels mFirstUse;                  /*!< Pick the kernels, then call them */
+    static std::atomic<const Kernels*> mKernels; /*!< Kernels used by the lexer, mFirstUse until the first call */
+};
+
+}  // namespace Crust
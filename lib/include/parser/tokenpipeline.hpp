@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <common/sourcebuffer.hpp>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <parser/lexer.hpp>
+#include <parser/tokenview.hpp>
+#include <thread>
+#include <vector>
+
+namespace Crust {
+
+/*
+ * \class TokenPipeline
+ * \brief Lexes a source on a thread of its own, ahead of the thread reading the tokens
+ *
+ * The producer thread lexes into batches of tokens held in a single-producer single-consumer ring.
+ * It publishes a batch by bumping mHead and blocks while the ring is full, until the consumer hands a
+ * batch back by bumping mTail. Both sides wait on those counters with std::atomic::wait, so neither
+ * spins or takes a lock.
+ *
+ * As in Lexer::lexAllParallel, the producer neither interns nor reports: it hashes the symbol text
+ * and keeps diagnostics with their token. next() interns and prints them as it returns the token,
+ * so the symbols and the diagnostics, interleaved with those of the consumer, are exactly what the
+ * consumer would get from Lexer::getNextToken. An exception thrown by the producer, such as a
+ * bad_alloc growing a batch, ends its batch and is rethrown by next() after the tokens before it.
+ */
+class TokenPipeline {
+   public:
+    static constexpr std::size_t DEFAULT_BATCH_SIZE = 1024;
+    static constexpr std::size_t DEFAULT_BATCHES = 8;
+
+    // The number of batches is rounded up to a power of two, at least 2
+    explicit TokenPipeline(std::shared_ptr<const SourceBuffer> source, std::size_t batchSize = DEFAULT_BATCH_SIZE,
+                           std::size_t batches = DEFAULT_BATCHES);
+    // Stops the producer if it has not reached the end of the source
+    ~TokenPipeline();
+
+    TokenPipeline(const TokenPipeline&) = delete;
+    TokenPipeline& operator=(const TokenPipeline&) = delete;
+
+    // Next token without comments, TOK_EOF again once the source is exhausted
+    LexedToken next();
+
+    const std::shared_ptr<const SourceBuffer>& getSourceBuffer() const { return mSource; }
+
+   private:
+    struct Batch {
+        std::vector<Lexer::SpeculativeToken> tokens;
+        std::vector<Lexer::SpeculativeError> errors; /*!< In token order */
+        std::exception_ptr exception;               /*!< Thrown by the producer after the tokens, ends the stream */
+    };
+
+    void produce();
+    // Waits for the next batch, handing the current one back
+    void acquireBatch();
+
+   private:
+    std::shared_ptr<const SourceBuffer> mSource;
+    Lexer mLexer; /*!< Used by the producer only */
+    std::size_t mBatchSize;
+    std::vector<Batch> mBatches;
+
+    alignas(64) std::atomic<std::size_t> mHead{0}; /*!< Batches published by the producer */
+    alignas(64) std::atomic<std::size_t> mTail{0}; /*!< Batches handed back by the consumer */
+    std::atomic<bool> mStop{false};
+
+    // Consumer side
+    const Batch* mBatch = nullptr; /*!< Batch being read, the one at mTail */
+    std::size_t mNext = 0;         /*!< Next token of mBatch */
+    std::size_t mNextError = 0;    /*!< Next error of mBatch */
+    bool mExhausted = false;       /*!< TOK_EOF was returned */
+    LexedToken mEof;
+
+    std::thread mProducer;
+};
+
+}  // namespace Crust
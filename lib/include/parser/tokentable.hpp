@@ -0,0 +1,92 @@
+#pragma once
+
+#include <common/sourcebuffer.hpp>
+#include <common/sourceloc.hpp>
+#include <common/symbolpool.hpp>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <parser/lexer.hpp>
+#include <string_view>
+#include <vector>
+
+namespace Crust {
+
+/*
+ * \class TokenTable
+ * \brief A whole buffer worth of tokens, stored as parallel arrays
+ *
+ * Produced by Lexer::lexAll. Token i is described by mKinds[i], mOffsets[i], mLengths[i] and
+ * mPayloads[i]. For identifiers and string literals the payload is the id of their Symbol in
+ * SymbolPool::global(), for number literals it indexes mInts or mFloats. The last token of a table
+ * is always TOK_EOF.
+ *
+ * splice does not renumber the tokens after an edit. Their offsets are stored without the shift the
+ * last edit left pending, so only the tokens between two edits are rewritten, and the numbers of
+ * relexed tokens take the slots freed by the ones they replace, so mInts and mFloats never outgrow
+ * the most numbers the table held at once. Only an edit changing the number of tokens still moves
+ * the ones after it.
+ */
+class TokenTable {
+   public:
+    static constexpr std::uint32_t NO_PAYLOAD = std::numeric_limits<std::uint32_t>::max();
+
+    TokenTable() = default;
+    explicit TokenTable(std::shared_ptr<const SourceBuffer> source) : mSource{std::move(source)} {}
+
+   public:
+    std::size_t size() const { return mKinds.size(); }
+    bool empty() const { return mKinds.empty(); }
+
+    Lexer::Token getKind(std::size_t idx) const { return static_cast<Lexer::Token>(mKinds[idx]); }
+    std::uint64_t getOffset(std::size_t idx) const { return mOffsets[idx] + (idx >= mShiftFrom ? mShift : 0); }
+    std::uint64_t getLength(std::size_t idx) const { return mLengths[idx]; }
+    std::uint32_t getPayloadIndex(std::size_t idx) const { return mPayloads[idx]; }
+
+    std::uint64_t getInt(std::size_t idx) const { return mInts[mPayloads[idx]]; }
+    double getFloat(std::size_t idx) const { return mFloats[mPayloads[idx]]; }
+    Symbol getSymbol(std::size_t idx) const { return Symbol(mPayloads[idx]); }
+    std::string_view getStr(std::size_t idx) const { return SymbolPool::global().get(getSymbol(idx)); }
+
+    std::string_view getText(std::size_t idx) const { return getSource().substr(getOffset(idx), mLengths[idx]); }
+    std::string_view getSource() const { return mSource ? mSource->getContents() : std::string_view{}; }
+    const std::shared_ptr<const SourceBuffer>& getSourceBuffer() const { return mSource; }
+
+    // Location just past token idx, as Lexer::GetCurrentLocation reports it
+    SourceLocation getEndLocation(std::size_t idx) const { return SourceLocation(getOffset(idx) + mLengths[idx]); }
+
+    void reserve(std::size_t count);
+    void push(Lexer::Token kind, std::uint64_t offset, std::uint64_t length);
+    void pushInt(Lexer::Token kind, std::uint64_t offset, std::uint64_t length, std::uint64_t value);
+    void pushFloat(Lexer::Token kind, std::uint64_t offset, std::uint64_t length, double value);
+    void pushSymbol(Lexer::Token kind, std::uint64_t offset, std::uint64_t length, Symbol value);
+
+    // Replaces tokens [first, last) with those of replacement, shifts the offsets of the tokens after
+    // them by delta and moves the table to source. Used by Lexer::relex
+    void splice(std::size_t first, std::size_t last, const TokenTable& replacement, std::int64_t delta,
+                std::shared_ptr<const SourceBuffer> source);
+
+   private:
+    template <typename T>
+    static void replaceRange(std::vector<T>& values, std::size_t first, std::size_t last, const std::vector<T>& replacement);
+    // Slot of value in values, a free one if any
+    template <typename T>
+    static std::uint32_t store(std::vector<T>& values, std::vector<std::uint32_t>& freeSlots, T value);
+
+    std::shared_ptr<const SourceBuffer> mSource; /*!< Keeps the bytes the tokens were lexed from alive */
+
+    std::vector<std::uint8_t> mKinds;     /*!< Lexer::Token of every token */
+    std::vector<std::uint64_t> mOffsets;  /*!< Byte offset of the first character of every token, 64-bit like the offsets of a stream */
+    std::vector<std::uint64_t> mLengths;  /*!< Length in bytes of every token, an error recovery may span more than 4 GiB */
+    std::vector<std::uint32_t> mPayloads; /*!< Index into the payload array of the token, or NO_PAYLOAD */
+
+    std::size_t mShiftFrom = 0; /*!< First token whose offset in mOffsets lacks mShift */
+    std::uint64_t mShift = 0;   /*!< Shift left pending by the last splice, wraps around when negative */
+
+    std::vector<std::uint64_t> mInts;
+    std::vector<double> mFloats;
+    std::vector<std::uint32_t> mFreeInts;   /*!< Slots of mInts no token uses since a splice */
+    std::vector<std::uint32_t> mFreeFloats; /*!< Slots of mFloats no token uses since a splice */
+};
+
+}  // namespace Crust
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <common/generator.hpp>
+#include <common/symbolpool.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <parser/lexer.hpp>
+#include <ranges>
+#include <string_view>
+#include <variant>
+
+namespace Crust {
+
+/*
+ * \class LexedToken
+ * \brief A token by value: its kind, the bytes it spans and its payload
+ *
+ * The payload is the value of a number literal, or the Symbol of an identifier or string literal.
+ */
+struct LexedToken {
+    using Payload = std::variant<std::monostate, std::uint64_t, double, Symbol>;
+
+    Lexer::Token kind = Lexer::Token::UNKNOWN;
+    std::uint64_t offset = 0;
+    std::uint64_t length = 0;
+    Payload payload;
+
+    // The token the lexer just returned
+    static LexedToken fromLexer(const Lexer& lexer, Lexer::Token kind) {
+        LexedToken token{kind, lexer.getCurrentTokenOffset(), lexer.getCurrentTokenLength(), {}};
+        switch (kind) {
+            case Lexer::Token::INT_LITERAL:
+                token.payload = lexer.getCurrentInt();
+                break;
+            case Lexer::Token::FLOAT_LITERAL:
+                token.payload = lexer.getCurrentFloat();
+                break;
+            case Lexer::Token::IDENTIFIER:
+            case Lexer::Token::STR_LITERAL:
+                token.payload = lexer.getCurrentSymbol();
+                break;
+            default:
+                break;
+        }
+        return token;
+    }
+
+    std::uint64_t getInt() const { return std::get<std::uint64_t>(payload); }
+    double getFloat() const { return std::get<double>(payload); }
+    Symbol getSymbol() const { return std::get<Symbol>(payload); }
+    std::string_view getStr() const { return SymbolPool::global().get(getSymbol()); }
+
+    bool operator==(const LexedToken&) const = default;
+};
+
+/*
+ * \class TokenView
+ * \brief The tokens of a lexer as a lazy input range, up to and without TOK_EOF
+ *
+ * Like std::ranges::istream_view, the view reads the first token when begin() is called and one more
+ * token on every increment, and keeps the last one by value. It holds a reference to the lexer, which
+ * must outlive it and is left just past the last token read. Nothing is allocated per token.
+ */
+class TokenView : public std::ranges::view_interface<TokenView> {
+   public:
+    class Iterator {
+       public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = LexedToken;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        const LexedToken& operator*() const { return mView->mCurrent; }
+        const LexedToken* operator->() const { return &mView->mCurrent; }
+
+        Iterator& operator++() {
+            mView->next();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return mView->mCurrent.kind == Lexer::Token::TOK_EOF; }
+
+       private:
+        friend class TokenView;
+
+        explicit Iterator(TokenView* view) : mView{view} {}
+
+        TokenView* mView = nullptr;
+    };
+
+   public:
+    TokenView() = default;
+    // With keepComments, COMMENT tokens are part of the range
+    explicit TokenView(Lexer& lexer, bool keepComments = false) : mLexer{&lexer}, mKeepComments{keepComments} {}
+
+    // Reads the first token, only call once
+    Iterator begin() {
+        next();
+        return Iterator(this);
+    }
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+
+   private:
+    void next() {
+        const Lexer::Token kind = mKeepComments ? mLexer->getNextTokenAndComment() : mLexer->getNextToken();
+        mCurrent = LexedToken::fromLexer(*mLexer, kind);
+    }
+
+   private:
+    Lexer* mLexer = nullptr;
+    bool mKeepComments = false;
+    LexedToken mCurrent; /*!< Token the iterators point at */
+};
+
+// Same tokens as TokenView, yielded by a coroutine
+Generator<LexedToken> generateTokens(Lexer& lexer, bool keepComments = false);
+
+}  // namespace Crust
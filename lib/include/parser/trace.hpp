@@ -0,0 +1,100 @@
+#pragma once
+
+#include <CFG/cfg.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <parser/lexer.hpp>
+#include <vector>
+
+// Set to 1 by the CRUST_TRACE CMake option
+#ifndef CRUST_TRACE
+#define CRUST_TRACE 0
+#endif
+
+namespace Crust {
+
+/*
+ * \class Trace
+ * \brief Binary trace of the tokens returned by the lexer and of the rules run by the parser
+ *
+ * In a build with CRUST_TRACE set, Lexer::getNextToken records every token it returns and every
+ * Parser::parse* function records entering and leaving its rule. Records are 16 bytes stored into
+ * a ring, so tracing a large file costs one store per event, keeps the last getCapacity() events
+ * and never goes through iostreams. Otherwise Trace::enabled is false and the hooks sit behind
+ * `if constexpr`, so nothing of them is left in the build.
+ *
+ * The parser lexes ahead of the rule it is in, so a token shows up a few records before the rule
+ * that consumes it. Every thread records into its own trace.
+ */
+class Trace {
+   public:
+    static constexpr bool enabled = CRUST_TRACE;
+
+    static constexpr std::size_t DEFAULT_CAPACITY = 1 << 20;
+
+    enum class Event : std::uint8_t {
+        TOKEN,
+        ENTER_RULE,
+        EXIT_RULE,
+    };
+
+    struct Record {
+        std::uint64_t offset; /*!< Start of the token, or end of the current token for rules */
+        std::uint32_t length; /*!< Length of the token, saturated at 2^32 - 1, 0 for rules */
+        std::uint16_t id;     /*!< Lexer::Token, or CFGNode::NodeKind for rules */
+        Event event;
+        std::uint8_t depth; /*!< Rules entered and not left yet, saturated at 255 */
+    };
+    static_assert(sizeof(Record) == 16);
+
+    // Trace of the calling thread
+    static Trace& local();
+
+    // Capacity is rounded up to a power of two
+    explicit Trace(std::size_t capacity = DEFAULT_CAPACITY);
+
+    void token(Lexer::Token kind, std::uint64_t offset, std::uint64_t length) {
+        push({offset, (std::uint32_t)std::min<std::uint64_t>(length, UINT32_MAX), (std::uint16_t)kind, Event::TOKEN, depth()});
+    }
+    void enterRule(CFGNode::NodeKind rule, std::uint64_t offset) {
+        push({offset, 0, (std::uint16_t)rule, Event::ENTER_RULE, depth()});
+        ++mDepth;
+    }
+    void exitRule(CFGNode::NodeKind rule, std::uint64_t offset) {
+        if (mDepth > 0)
+            --mDepth;
+        push({offset, 0, (std::uint16_t)rule, Event::EXIT_RULE, depth()});
+    }
+
+    void clear();
+
+    std::size_t getCapacity() const { return mRecords.size(); }
+    std::size_t size() const { return mCount < mRecords.size() ? mCount : mRecords.size(); }
+    // Records overwritten by newer ones
+    std::uint64_t getDropped() const { return mCount - size(); }
+
+    // Kept records, oldest first
+    std::vector<Record> getRecords() const;
+
+    // Writes the kept records as they are in memory, oldest first
+    void dump(std::ostream& stream) const;
+    // Writes the kept records as text, one per line and indented by depth
+    void print(std::ostream& stream) const;
+
+   private:
+    std::uint8_t depth() const { return mDepth < 255 ? mDepth : 255; }
+
+    void push(const Record& record) {
+        mRecords[mCount & (mRecords.size() - 1)] = record;
+        ++mCount;
+    }
+
+   private:
+    std::vector<Record> mRecords;
+    std::uint64_t mCount = 0; /*!< Records pushed since the last clear() */
+    unsigned mDepth = 0;
+};
+
+}  // namespace Crust
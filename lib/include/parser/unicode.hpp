@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Crust {
+
+/*
+ * \class Unicode
+ * \brief UTF-8 decoding and the character classes used by the lexer
+ *
+ * Identifiers follow the default identifier syntax of UAX #31: an XID_Start code point or '_', then
+ * XID_Continue code points. ASCII bytes are classified with a constexpr table, so the lexer only
+ * decodes and looks up the XID ranges once it meets a byte >= 0x80. Decoding is strict: overlong
+ * forms, surrogates and code points past U+10FFFF are invalid.
+ */
+class Unicode {
+   public:
+    Unicode() = delete;
+
+    // A code point decoded from UTF-8
+    struct Decoded {
+        char32_t codePoint; /*!< U+FFFD when invalid */
+        unsigned length;    /*!< Bytes used, or for an invalid sequence the length of its longest valid prefix, at least 1 */
+        bool valid;
+    };
+
+   public:
+    static constexpr bool isAscii(char c) { return (unsigned char)c < 0x80; }
+
+    // ASCII only, false for every byte >= 0x80
+    static constexpr bool isDigit(char c) { return asciiClasses[(unsigned char)c] & DIGIT; }
+    static constexpr bool isLetter(char c) { return asciiClasses[(unsigned char)c] & LETTER; }
+    static constexpr bool isIdentifierStart(char c) { return asciiClasses[(unsigned char)c] & IDENTIFIER_START; }
+    static constexpr bool isIdentifierContinue(char c) { return asciiClasses[(unsigned char)c] & IDENTIFIER_CONTINUE; }
+
+    // For code points >= 0x80, '_' and the ASCII letters and digits are found in the table above
+    static bool isXidStart(char32_t codePoint);
+    static bool isXidContinue(char32_t codePoint);
+
+    // Code point starting at it, it must not be end
+    static Decoded decode(const char* it, const char* end);
+
+    // Start of the first invalid sequence in [it, end), or end
+    static const char* validate(const char* it, const char* end);
+
+   private:
+    enum : std::uint8_t {
+        DIGIT = 1 << 0,
+        LETTER = 1 << 1,
+        IDENTIFIER_START = 1 << 2,
+        IDENTIFIER_CONTINUE = 1 << 3,
+    };
+
+    // Classes of every byte, none from 0x80
+    static constexpr std::array<std::uint8_t, 256> asciiClasses = [] {
+        std::array<std::uint8_t, 256> classes{};
+        for (unsigned c = '0'; c <= '9'; ++c) classes[c] = DIGIT | IDENTIFIER_CONTINUE;
+        for (unsigned c = 'a'; c <= 'z'; ++c) classes[c] = LETTER | IDENTIFIER_START | IDENTIFIER_CONTINUE;
+        for (unsigned c = 'A'; c <= 'Z'; ++c) classes[c] = LETTER | IDENTIFIER_START | IDENTIFIER_CONTINUE;
+        classes['_'] = IDENTIFIER_START | IDENTIFIER_CONTINUE;
+        return classes;
+    }();
+};
+
+}  // namespace Crust
@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <array>
+#include <common/corpusgenerator.hpp>
+#include <sstream>
+
+using namespace Crust;
+
+namespace {
+
+constexpr std::array<std::string_view, 6> shapeNames = {"functions", "conditionals", "declarations", "expressions", "nesting", "mixed"};
+
+constexpr std::array<std::string_view, 8> atomicTypes = {"i32", "i64", "u32", "u64", "f32", "f64", "string", "bool"};
+
+constexpr std::array<std::string_view, 13> binaryOperators = {"+", "-", "*", "/", "%", "and", "or", ">", ">=", "==", "!=", "<=", "<"};
+
+// Deeper levels are written at this indentation, so that deep nesting does not grow quadratically
+constexpr unsigned MAX_INDENT = 16;
+
+}  // namespace
+
+CorpusGenerator::CorpusGenerator(const Options& options) : mOptions{options}, mState{options.seed} {
+    mOptions.depth = std::max(mOptions.depth, 1u);
+}
+
+std::optional<CorpusGenerator::Shape> CorpusGenerator::parseShape(std::string_view name) {
+    for (std::size_t idx = 0; idx < shapeNames.size(); ++idx)
+        if (shapeNames[idx] == name)
+            return Shape(idx);
+    return std::nullopt;
+}
+
+std::string_view CorpusGenerator::getShapeName(Shape shape) {
+    return shapeNames[(std::size_t)shape];
+}
+
+std::uint64_t CorpusGenerator::generate(std::ostream& out) {
+    mState = mOptions.seed;
+    mFunctions = 0;
+
+    std::uint64_t written = 0;
+    while (written < mOptions.size) {
+        mBuffer.clear();
+        mIndent = 0;
+        declaration(mOptions.shape, mOptions.depth);
+        out.write(mBuffer.data(), mBuffer.size());
+        written += mBuffer.size();
+    }
+    return written;
+}
+
+std::string CorpusGenerator::generate() {
+    std::ostringstream out;
+    generate(out);
+    return out.str();
+}
+
+std::uint64_t CorpusGenerator::random() {
+    // splitmix64
+    std::uint64_t z = (mState += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+std::uint64_t CorpusGenerator::below(std::uint64_t bound) {
+    return random() % bound;
+}
+
+void CorpusGenerator::declaration(Shape shape, unsigned depth) {
+    if (shape == Shape::MIXED)
+        return declaration(Shape(below((std::size_t)Shape::MIXED)), 1 + below(depth));
+
+    if (shape == Shape::DECLARATIONS)
+        variableDeclaration(depth);
+    else
+        functionDeclaration(shape, depth);
+}
+
+void CorpusGenerator::variableDeclaration(unsigned count) {
+    openLine();
+    type();
+    for (unsigned idx = 0; idx < count; ++idx) {
+        mBuffer += idx == 0 ? " " : ", ";
+        variable();
+    }
+    closeLine(";");
+}
+
+void CorpusGenerator::functionDeclaration(Shape shape, unsigned depth) {
+    mBuffer += "fn fun" + std::to_string(mFunctions++) + "(";
+    for (unsigned idx = 0, count = below(4); idx < count; ++idx) {
+        if (idx != 0)
+            mBuffer += ", ";
+        type();
+        mBuffer += ' ';
+        variable();
+    }
+    mBuffer += ") ";
+    if (chance(20))
+        mBuffer += "void";
+    else
+        type();
+    mBuffer += " {\n";
+
+    ++mIndent;
+    switch (shape) {
+        case Shape::CONDITIONALS:
+            conditional(depth, 1);
+            break;
+        case Shape::EXPRESSIONS:
+            for (unsigned idx = 0, count = 1 + below(3); idx < count; ++idx) {
+                openLine();
+                variable();
+                mBuffer += " = ";
+                expression(depth, 1);
+                closeLine(";");
+            }
+            break;
+        case Shape::NESTING:
+            nested(depth);
+            break;
+        default:
+            statements(2 + below(4), 1);
+            break;
+    }
+
+    openLine();
+    mBuffer += "return ";
+    expression(1 + below(3), 1);
+    closeLine(";");
+    --mIndent;
+    closeLine("}");
+}
+
+void CorpusGenerator::statements(unsigned count, unsigned depth) {
+    for (unsigned idx = 0; idx < count; ++idx) statement(depth);
+}
+
+void CorpusGenerator::statement(unsigned depth) {
+    switch (below(depth == 0 ? 4 : 8)) {
+        case 0:
+            variableDeclaration(1 + below(3));
+            break;
+        case 1:
+        case 2:
+            openLine();
+            variable();
+            mBuffer += " = ";
+            expression(1 + below(4), depth);
+            closeLine(";");
+            break;
+        case 3:
+            openLine();
+            function();
+            mBuffer += '(';
+            for (unsigned idx = 0, count = below(3); idx < count; ++idx) {
+                if (idx != 0)
+                    mBuffer += ", ";
+                expression(1 + below(2), depth);
+            }
+            closeLine(");");
+            break;
+        case 4:
+            conditional(below(3), depth - 1);
+            break;
+        case 5:
+            openLine();
+            mBuffer += "while ";
+            expression(1 + below(3), depth - 1);
+            mBuffer += ' ';
+            segment(1 + below(3), depth - 1);
+            closeLine("");
+            break;
+        case 6:
+            openLine();
+            mBuffer += "for ";
+            variable();
+            mBuffer += " in ";
+            bound();
+            mBuffer += " .. ";
+            bound();
+            if (chance(25)) {
+                mBuffer += " .. ";
+                bound();
+            }
+            mBuffer += ' ';
+            segment(1 + below(3), depth - 1);
+            closeLine("");
+            break;
+        default:
+            openLine();
+            segment(1 + below(3), depth - 1);
+            closeLine("");
+            break;
+    }
+}
+
+void CorpusGenerator::conditional(unsigned elifs, unsigned depth) {
+    openLine();
+    mBuffer += "if ";
+    expression(1 + below(3), depth);
+    mBuffer += ' ';
+    segment(1 + below(2), depth);
+
+    for (unsigned idx = 0; idx < elifs; ++idx) {
+        mBuffer += " elif ";
+        expression(1 + below(3), depth);
+        mBuffer += ' ';
+        segment(1 + below(2), depth);
+    }
+
+    if (chance(50)) {
+        mBuffer += " else ";
+        segment(1 + below(2), depth);
+    }
+    closeLine("");
+}
+
+void CorpusGenerator::nested(unsigned depth) {
+    if (depth == 0)
+        return statements(1 + below(2), 0);
+
+    openLine();
+    switch (below(4)) {
+        case 0:
+            mBuffer += "if ";
+            expression(1 + below(3), 0);
+            mBuffer += ' ';
+            break;
+        case 1:
+            mBuffer += "while ";
+            expression(1 + below(3), 0);
+            mBuffer += ' ';
+            break;
+        case 2:
+            mBuffer += "for ";
+            variable();
+            mBuffer += " in 0 .. ";
+            bound();
+            mBuffer += ' ';
+            break;
+        default:
+            break;
+    }
+
+    mBuffer += "{\n";
+    ++mIndent;
+    statement(0);
+    nested(depth - 1);
+    --mIndent;
+    openLine();
+    closeLine("}");
+}
+
+void CorpusGenerator::segment(unsigned count, unsigned depth) {
+    mBuffer += "{\n";
+    ++mIndent;
+    statements(count, depth);
+    --mIndent;
+    openLine();
+    mBuffer += '}';
+}
+
+void CorpusGenerator::expression(unsigned operands, unsigned depth) {
+    for (unsigned idx = 0; idx < operands; ++idx) {
+        if (idx != 0) {
+            mBuffer += ' ';
+            mBuffer += binaryOperators[below(binaryOperators.size())];
+            mBuffer += ' ';
+        }
+        term(depth);
+    }
+}
+
+void CorpusGenerator::term(unsigned depth) {
+    switch (below(depth == 0 ? 6 : 10)) {
+        case 0:
+        case 1:
+            variable();
+            break;
+        case 2:
+            mBuffer += std::to_string(below(1000));
+            break;
+        case 3:
+            mBuffer += std::to_string(below(100)) + "." + std::to_string(below(100));
+            break;
+        case 4:
+            mBuffer += "\"s" + std::to_string(below(1000)) + "\"";
+            break;
+        case 5:
+            mBuffer += chance(50) ? "true" : "false";
+            break;
+        case 6:
+        case 7:
+            function();
+            mBuffer += '(';
+            for (unsigned idx = 0, count = below(3); idx < count; ++idx) {
+                if (idx != 0)
+                    mBuffer += ", ";
+                expression(1 + below(2), depth - 1);
+            }
+            mBuffer += ')';
+            break;
+        case 8:
+            variable();
+            mBuffer += '[';
+            expression(1 + below(2), depth - 1);
+            mBuffer += ']';
+            break;
+        default:
+            mBuffer += '(';
+            expression(2 + below(2), depth - 1);
+            mBuffer += ')';
+            break;
+    }
+}
+
+void CorpusGenerator::bound() {
+    if (chance(50))
+        variable();
+    else
+        mBuffer += std::to_string(below(1000));
+}
+
+void CorpusGenerator::type() {
+    if (chance(10))
+        mBuffer += "[" + std::to_string(1 + below(64)) + "] ";
+    mBuffer += atomicTypes[below(atomicTypes.size())];
+}
+
+void CorpusGenerator::variable() {
+    mBuffer += "v" + std::to_string(below(64));
+}
+
+void CorpusGenerator::function() {
+    // Not f followed by digits, which would spell f32 and f64
+    mBuffer += "fun" + std::to_string(below(mFunctions));
+}
+
+void CorpusGenerator::openLine() {
+    mBuffer.append(4 * std::min(mIndent, MAX_INDENT), ' ');
+}
+
+void CorpusGenerator::closeLine(std::string_view text) {
+    mBuffer += text;
+    mBuffer += '\n';
+}
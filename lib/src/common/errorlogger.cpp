@@ -1,5 +1,7 @@
 #include <common/errorlogger.hpp>
+#include <common/sourcebuffer.hpp>
 #include <common/sourceloc.hpp>
+#include <common/sourcemanager.hpp>
 #include <iostream>
 
 using namespace Crust;
@@ -8,6 +10,7 @@ std::unordered_map<ErrorLogger::ErrorType, std::string> ErrorLogger::mErrorMessa
     {
         // Symbol
         {ErrorType::INVALID_SYMBOL, "ERROR: Invalid Symbol used"},
+        {ErrorType::INVALID_UTF8, "ERROR: Invalid UTF-8 sequence"},
         // Array
         {ErrorType::ARRAY_EMPTY_EXPR, "ERROR: Empty array expression"},
         {ErrorType::ARRAY_MISSING_COMMA, "ERROR: Missing comma between two array elements"},
@@ -59,6 +62,7 @@ std::unordered_map<ErrorLogger::ErrorType, std::string> ErrorLogger::mErrorMessa
         {ErrorType::NEW_LINE_IN_LITERAL, "LITERAL ERROR: Newline in string literal"},
         {ErrorType::MISSING_CLOSING_QUOTE, "LITERAL ERROR: Missing closing quote"},
         {ErrorType::NUMBER_BAD_SUFFIX, "LITERAL ERROR: Bad suffix on number"},
+        {ErrorType::NUMBER_OUT_OF_RANGE, "LITERAL ERROR: Number literal out of range"},
 
         // Misc
         {ErrorType::EXPECTED_DECL, "ERROR: Expected a declaration"},
@@ -102,6 +106,17 @@ void ErrorLogger::printError(ErrorType eType) {
     std::cerr << mErrorMessages[eType] << std::endl;
 }
 
-void ErrorLogger::printErrorAtLocation(ErrorType eType, const SourceLocation& srcLoc) {
-    std::cerr << mErrorMessages[eType] << " at line " << srcLoc.getCurrentLine() << ", column " << srcLoc.getCurrentColumn() << std::endl;
-}
\ No newline at end of file
+void ErrorLogger::printErrorAtLocation(ErrorType eType, const SourceBuffer& source, const SourceLocation& srcLoc) {
+    printErrorAtLocation(eType, source.getLineColumn(srcLoc));
+}
+
+void ErrorLogger::printErrorAtLocation(ErrorType eType, const LineColumn& position) {
+    std::cerr << mErrorMessages[eType] << " at line " << position.line << ", column " << position.column << std::endl;
+}
+
+void ErrorLogger::printErrorAtLocation(ErrorType eType, const SourceManager& sources, const GlobalLocation& srcLoc) {
+    const auto position = sources.getLineColumn(srcLoc);
+    if (!position)
+        return printError(eType);
+    std::cerr << mErrorMessages[eType] << " in " << sources.getName(sources.getFileID(srcLoc)) << " at line " << position->line << ", column " << position->column << std::endl;
+}
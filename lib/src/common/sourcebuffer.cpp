@@ -0,0 +1,108 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <common/sourcebuffer.hpp>
+#include <parser/scan.hpp>
+
+using namespace Crust;
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::fromFile(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    auto buffer = fromFileDescriptor(fd, filename);
+    ::close(fd);
+    return buffer;
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::fromFileDescriptor(int fd, const std::string& name) {
+    std::shared_ptr<SourceBuffer> buffer(new SourceBuffer(name));
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+        return nullptr;
+
+    // Regular, non-empty files are mapped directly. The mapping outlives the descriptor.
+    if (S_ISREG(info.st_mode) and info.st_size > 0) {
+        void* mapping = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            ::madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+            buffer->mMapping = mapping;
+            buffer->mMappingSize = info.st_size;
+            buffer->mContents = std::string_view(static_cast<const char*>(mapping), info.st_size);
+            return buffer;
+        }
+    }
+
+    // Fallback for pipes and anything else that cannot be mapped
+    char chunk[64 * 1024];
+    for (;;) {
+        ssize_t count = ::read(fd, chunk, sizeof(chunk));
+        if (count == 0)
+            break;
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            return nullptr;
+        }
+        buffer->mStorage.append(chunk, count);
+    }
+
+    buffer->mContents = buffer->mStorage;
+    return buffer;
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::fromString(std::string contents, const std::string& name) {
+    std::shared_ptr<SourceBuffer> buffer(new SourceBuffer(name));
+    buffer->mStorage = std::move(contents);
+    buffer->mContents = buffer->mStorage;
+    return buffer;
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::edit(const SourceBuffer& buffer, std::size_t offset, std::size_t length,
+                                                       std::string_view text) {
+    const std::string_view old = buffer.getContents();
+    std::string contents;
+    contents.reserve(old.size() - length + text.size());
+    contents.append(old.substr(0, offset)).append(text).append(old.substr(offset + length));
+    return fromString(std::move(contents), buffer.getName());
+}
+
+std::shared_ptr<const SourceBuffer> SourceBuffer::fromView(std::string_view contents, const std::string& name, std::shared_ptr<const void> owner) {
+    std::shared_ptr<SourceBuffer> buffer(new SourceBuffer(name));
+    buffer->mOwner = std::move(owner);
+    buffer->mContents = contents;
+    return buffer;
+}
+
+SourceBuffer::~SourceBuffer() {
+    if (mMapping)
+        ::munmap(mMapping, mMappingSize);
+}
+
+const std::vector<std::uint64_t>& SourceBuffer::getLineStarts() const {
+    std::call_once(mLineStartsBuilt, [this] {
+        const char* begin = mContents.data();
+        const char* end = begin + mContents.size();
+
+        mLineStarts.push_back(0);
+        for (const char* it = Scan::findNewline(begin, end); it != end; it = Scan::findNewline(it + 1, end))
+            mLineStarts.push_back(it + 1 - begin);
+    });
+    return mLineStarts;
+}
+
+LineColumn SourceBuffer::getLineColumn(SourceLocation location) const {
+    const auto& lineStarts = getLineStarts();
+    const std::uint64_t offset = std::min<std::uint64_t>(location.getOffset(), mContents.size());
+
+    // The line is the last one starting at or before the offset
+    const auto next = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    const unsigned line = next - lineStarts.begin();
+    return {line, static_cast<unsigned>(offset - lineStarts[line - 1] + 1)};
+}
@@ -0,0 +1,126 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <common/sourcemanager.hpp>
+#include <cstring>
+
+using namespace Crust;
+
+namespace {
+
+// One byte past the largest offset, GlobalLocation::INVALID is never handed out
+constexpr std::uint64_t ADDRESS_SPACE = std::uint64_t(1) << 32;
+
+}  // namespace
+
+SourceManager::SourceManager() : mPageSize{(std::size_t)::sysconf(_SC_PAGESIZE)} {
+    // Only address space is reserved, pages are mapped in as files are added
+    void* arena = ::mmap(nullptr, ADDRESS_SPACE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (arena != MAP_FAILED)
+        mArena = std::shared_ptr<char>(static_cast<char*>(arena), [](char* arena) { ::munmap(arena, ADDRESS_SPACE); });
+}
+
+FileID SourceManager::addFile(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return FileID();
+
+    FileID file = addFileDescriptor(fd, filename);
+    ::close(fd);
+    return file;
+}
+
+FileID SourceManager::addFileDescriptor(int fd, const std::string& name) {
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+        return FileID();
+
+    // Regular files are mapped straight into their range. The mapping outlives the descriptor.
+    if (mArena and S_ISREG(info.st_mode) and info.st_size > 0) {
+        const auto base = allocate(info.st_size);
+        if (!base)
+            return FileID();
+
+        char* at = mArena.get() + *base;
+        if (::mmap(at, info.st_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED) {
+            ::madvise(at, info.st_size, MADV_SEQUENTIAL);
+            return addBuffer(*base, info.st_size, SourceBuffer::fromView(std::string_view(at, info.st_size), name, mArena));
+        }
+    }
+
+    auto buffer = SourceBuffer::fromFileDescriptor(fd, name);
+    if (!buffer)
+        return FileID();
+
+    const std::size_t size = buffer->getSize();
+    const auto base = allocate(size);
+    if (!base)
+        return FileID();
+    if (mArena)
+        buffer = copyToArena(*base, buffer->getContents(), name);
+    return addBuffer(*base, size, std::move(buffer));
+}
+
+FileID SourceManager::addString(std::string_view contents, const std::string& name) {
+    const auto base = allocate(contents.size());
+    if (!base)
+        return FileID();
+
+    auto buffer = mArena ? copyToArena(*base, contents, name) : SourceBuffer::fromString(std::string(contents), name);
+    return addBuffer(*base, contents.size(), std::move(buffer));
+}
+
+FileID SourceManager::getFileID(GlobalLocation location) const {
+    if (!location.isValid() or location.getOffset() >= mEnd)
+        return FileID();
+
+    // The file is the last one starting at or before the offset
+    const auto next = std::upper_bound(mBases.begin(), mBases.end(), location.getOffset());
+    return FileID(next - mBases.begin() - 1);
+}
+
+std::optional<SourceLocation> SourceManager::getLocalLocation(GlobalLocation location) const {
+    const FileID file = getFileID(location);
+    if (!file.isValid())
+        return std::nullopt;
+    return SourceLocation(location.getOffset() - mBases[file.getId()]);
+}
+
+std::optional<LineColumn> SourceManager::getLineColumn(GlobalLocation location) const {
+    const FileID file = getFileID(location);
+    if (!file.isValid())
+        return std::nullopt;
+    return getBuffer(file)->getLineColumn(SourceLocation(location.getOffset() - mBases[file.getId()]));
+}
+
+std::optional<std::uint32_t> SourceManager::allocate(std::uint64_t size) const {
+    // One more offset for the end of file location
+    if (mEnd + size + 1 >= ADDRESS_SPACE)
+        return std::nullopt;
+    return mEnd;
+}
+
+FileID SourceManager::addBuffer(std::uint32_t base, std::uint64_t size, std::shared_ptr<const SourceBuffer> buffer) {
+    mBases.push_back(base);
+    mBuffers.push_back(std::move(buffer));
+
+    // Ranges start on a page so that files can be mapped at their base
+    mEnd = (base + size + 1 + mPageSize - 1) / mPageSize * mPageSize;
+    return FileID(mBuffers.size() - 1);
+}
+
+std::shared_ptr<const SourceBuffer> SourceManager::copyToArena(std::uint32_t base, std::string_view contents, const std::string& name) {
+    char* at = mArena.get() + base;
+    if (!contents.empty()) {
+        const std::size_t length = (contents.size() + mPageSize - 1) / mPageSize * mPageSize;
+        if (::mmap(at, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED)
+            return SourceBuffer::fromString(std::string(contents), name);
+
+        std::memcpy(at, contents.data(), contents.size());
+        ::mprotect(at, length, PROT_READ);
+    }
+    return SourceBuffer::fromView(std::string_view(at, contents.size()), name, mArena);
+}
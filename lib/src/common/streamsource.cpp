@@ -0,0 +1,80 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <common/streamsource.hpp>
+#include <cstring>
+#include <parser/scan.hpp>
+
+using namespace Crust;
+
+std::shared_ptr<StreamSource> StreamSource::fromStream(std::istream& stream, const std::string& name, std::size_t capacity) {
+    return std::make_shared<StreamSource>(
+        [&stream](char* buffer, std::size_t size) -> std::size_t {
+            stream.read(buffer, size);
+            return stream.gcount();
+        },
+        name, capacity);
+}
+
+std::shared_ptr<StreamSource> StreamSource::fromFileDescriptor(int fd, const std::string& name, std::size_t capacity) {
+    return std::make_shared<StreamSource>(
+        [fd](char* buffer, std::size_t size) -> std::size_t {
+            for (;;) {
+                ssize_t count = ::read(fd, buffer, size);
+                if (count >= 0)
+                    return count;
+                if (errno != EINTR)
+                    return 0;
+            }
+        },
+        name, capacity);
+}
+
+StreamSource::StreamSource(Reader reader, const std::string& name, std::size_t capacity)
+    : mReader{std::move(reader)}, mName{name}, mBuffer{std::make_unique<char[]>(capacity ? capacity : 1)}, mCapacity{capacity ? capacity : 1} {
+    refill(data());
+}
+
+void StreamSource::refill(const char* keep) {
+    const std::size_t dropped = keep - data();
+
+    // Count the lines of the dropped bytes so that later locations still resolve
+    const char* end = keep;
+    for (const char* it = Scan::findNewline(data(), end); it != end; it = Scan::findNewline(it + 1, end)) {
+        ++mLine;
+        mLineStart = mOffset + (it + 1 - data());
+    }
+
+    std::memmove(mBuffer.get(), keep, mSize - dropped);
+    mSize -= dropped;
+    mOffset += dropped;
+
+    if (mExhausted)
+        return;
+
+    // A single token fills the whole window, make room for the rest of it
+    if (mSize == mCapacity) {
+        auto larger = std::make_unique<char[]>(mCapacity * 2);
+        std::memcpy(larger.get(), mBuffer.get(), mSize);
+        mBuffer = std::move(larger);
+        mCapacity *= 2;
+    }
+
+    const std::size_t count = mReader(mBuffer.get() + mSize, mCapacity - mSize);
+    mSize += count;
+    mExhausted = count == 0;
+}
+
+LineColumn StreamSource::getLineColumn(SourceLocation location) const {
+    std::uint64_t line = mLine;
+    std::uint64_t lineStart = mLineStart;
+
+    const char* end = data() + std::min<std::uint64_t>(location.getOffset() - mOffset, mSize);
+    for (const char* it = Scan::findNewline(data(), end); it != end; it = Scan::findNewline(it + 1, end)) {
+        ++line;
+        lineStart = mOffset + (it + 1 - data());
+    }
+
+    return {static_cast<unsigned>(line), static_cast<unsigned>(location.getOffset() - lineStart + 1)};
+}
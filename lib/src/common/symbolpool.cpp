@@ -0,0 +1,79 @@
+#include <common/symbolpool.hpp>
+#include <cstring>
+
+using namespace Crust;
+
+SymbolPool::SymbolPool() : mSlots(1024, Symbol::INVALID) {}
+
+SymbolPool& SymbolPool::global() {
+    static SymbolPool pool;
+    return pool;
+}
+
+std::uint32_t SymbolPool::hash(std::string_view text) {
+    // FNV-1a, folded to 32 bits
+    std::uint64_t h = 0xcbf29ce484222325ull;
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 0x100000001b3ull;
+    }
+    return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+Symbol SymbolPool::intern(std::string_view text, std::uint32_t h) {
+    const std::size_t mask = mSlots.size() - 1;
+
+    std::size_t slot = h & mask;
+    for (; mSlots[slot] != Symbol::INVALID; slot = (slot + 1) & mask) {
+        const std::uint32_t id = mSlots[slot];
+        if (mHashes[id] == h and mStrings[id] == text)
+            return Symbol(id);
+    }
+
+    const std::uint32_t id = mStrings.size();
+    mStrings.emplace_back(store(text), text.size());
+    mHashes.push_back(h);
+    mSlots[slot] = id;
+
+    // Keep the table at most half full so probe sequences stay short
+    if (mStrings.size() * 2 > mSlots.size())
+        grow();
+
+    return Symbol(id);
+}
+
+const char* SymbolPool::store(std::string_view text) {
+    if (text.size() > mBlockLeft) {
+        // Long strings get a block of their own instead of wasting the rest of the current one
+        if (text.size() > BLOCK_SIZE / 4) {
+            mBlocks.push_back(std::make_unique<char[]>(text.size()));
+            char* bytes = mBlocks.back().get();
+            std::memcpy(bytes, text.data(), text.size());
+            return bytes;
+        }
+
+        mBlocks.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+        mBlockIt = mBlocks.back().get();
+        mBlockLeft = BLOCK_SIZE;
+    }
+
+    char* bytes = mBlockIt;
+    std::memcpy(bytes, text.data(), text.size());
+    mBlockIt += text.size();
+    mBlockLeft -= text.size();
+    return bytes;
+}
+
+void SymbolPool::grow() {
+    std::vector<std::uint32_t> slots(mSlots.size() * 2, Symbol::INVALID);
+    const std::size_t mask = slots.size() - 1;
+
+    for (std::uint32_t id = 0; id < mStrings.size(); ++id) {
+        std::size_t slot = mHashes[id] & mask;
+        while (slots[slot] != Symbol::INVALID)
+            slot = (slot + 1) & mask;
+        slots[slot] = id;
+    }
+
+    mSlots = std::move(slots);
+}
@@ -0,0 +1,73 @@
+#include <parser/dfatables.hpp>
+#include <parser/lexer.hpp>
+#include <parser/scan.hpp>
+#include <parser/unicode.hpp>
+
+using namespace Crust;
+
+Lexer::Token Lexer::lexDfa() {
+    advanceTo(Scan::skipWhitespace(mBufferIt, mBufferEnd));
+
+    mTokenIt = mBufferIt;
+
+    if (mBufferIt == mBufferEnd)
+        return Token::TOK_EOF;
+
+    // Longest match: run until the dead state, remembering the last accepting state seen
+    const char* it = mBufferIt;
+    const char* acceptedEnd = it;
+    std::uint8_t accepted = DfaTables::NO_TOKEN;
+    DfaTables::State state = DfaTables::START;
+    while (it != mBufferEnd) {
+        state = DfaTables::transitions[state * DfaTables::NUM_CLASSES + DfaTables::classOf[(unsigned char)*it]];
+        if (state == DfaTables::DEAD)
+            break;
+
+        ++it;
+        if (DfaTables::accepts[state] != DfaTables::NO_TOKEN) {
+            accepted = DfaTables::accepts[state];
+            acceptedEnd = it;
+        }
+    }
+
+    // Out of input in the middle of a longer candidate: getNextTokenAndComment reads more and retries
+    if (it == mBufferEnd and acceptedEnd != it and mStream and !mStream->isExhausted()) {
+        advanceTo(mBufferEnd);
+        return Token::UNKNOWN;
+    }
+
+    // Malformed input is rare, the hand-written lexer reports it and recovers exactly as before
+    if (accepted == DfaTables::NO_TOKEN or accepted == (std::uint8_t)Token::UNKNOWN)
+        return lexHandwritten();
+
+    const Token token = static_cast<Token>(accepted);
+    const char* tokenBegin = mBufferIt;
+    advanceTo(acceptedEnd);
+
+    switch (token) {
+        case Token::IDENTIFIER:
+            // The tables only know ASCII, an identifier may go on with other code points
+            if (acceptedEnd != mBufferEnd and !Unicode::isAscii(*acceptedEnd)) {
+                mBufferIt = tokenBegin;
+                return lexIdentifier(1);
+            }
+            mCurrentStr = std::string_view(tokenBegin, acceptedEnd - tokenBegin);
+            return tokenizeCurrentStr();
+        case Token::STR_LITERAL:
+            mCurrentStr = std::string_view(tokenBegin + 1, acceptedEnd - tokenBegin - 2);
+            if (Unicode::validate(mCurrentStr.data(), mCurrentStr.data() + mCurrentStr.size()) != mCurrentStr.data() + mCurrentStr.size()) {
+                mBufferIt = tokenBegin;
+                return lexHandwritten();
+            }
+            internCurrentStr();
+            return token;
+        case Token::INT_LITERAL:
+            parseInt(tokenBegin, acceptedEnd);
+            return token;
+        case Token::FLOAT_LITERAL:
+            parseFloat(tokenBegin, acceptedEnd);
+            return token;
+        default:
+            return token;
+    }
+}
@@ -1,9 +1,15 @@
 #include <algorithm>
+#include <cassert>
+#include <charconv>
 #include <common/errorlogger.hpp>
-#include <fstream>
-#include <iostream>
-#include <iterator>
+#include <common/symbolpool.hpp>
+#include <parser/keywords.hpp>
 #include <parser/lexer.hpp>
+#include <parser/scan.hpp>
+#include <parser/tokentable.hpp>
+#include <parser/trace.hpp>
+#include <parser/unicode.hpp>
+#include <utility>
 
 using namespace Crust;
 
@@ -74,30 +80,180 @@ const std::array<std::string, (size_t)Lexer::Token::UNKNOWN + 1> Lexer::token_to
 };
 
 bool Lexer::init(const std::string& filename) {
-    std::ifstream stream(filename);
-    if (stream) {
-        mBuffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
-        mBufferIt = mBuffer.begin();
-        mSrcLoc.init();
-        return true;
+    return init(SourceBuffer::fromFile(filename));
+}
+
+bool Lexer::init(std::shared_ptr<const SourceBuffer> source) {
+    if (!source)
+        return false;
+
+    mSource = std::move(source);
+    mStream = nullptr;
+    mBuffer = mSource->getContents();
+    mBufferOffset = 0;
+    mTokenOffset = 0;
+    mBufferIt = mBuffer.data();
+    mBufferEnd = mBuffer.data() + mBuffer.size();
+    mTokenIt = mBufferIt;
+    mCurrentStr = {};
+    mCurrentSymbol = Symbol();
+    mPendingError.reset();
+    return true;
+}
+
+bool Lexer::init(std::shared_ptr<StreamSource> stream) {
+    if (!stream)
+        return false;
+
+    mSource = nullptr;
+    mStream = std::move(stream);
+    mBuffer = std::string_view(mStream->data(), mStream->size());
+    mBufferOffset = mStream->getOffset();
+    mTokenOffset = mBufferOffset;
+    mBufferIt = mBuffer.data();
+    mBufferEnd = mBuffer.data() + mBuffer.size();
+    mTokenIt = mBufferIt;
+    mCurrentStr = {};
+    mCurrentSymbol = Symbol();
+    mPendingError.reset();
+    return true;
+}
+
+LineColumn Lexer::getLineColumn(SourceLocation location) const {
+    return mStream ? mStream->getLineColumn(location) : mSource->getLineColumn(location);
+}
+
+Lexer::Checkpoint Lexer::save() const {
+    Checkpoint checkpoint;
+    checkpoint.mLocation = GetCurrentLocation().getOffset();
+    checkpoint.mTokenOffset = mTokenOffset;
+    checkpoint.mInt = mCurrentInt;
+    checkpoint.mFloat = mCurrentFloat;
+    checkpoint.mStr = mCurrentStr;
+    checkpoint.mSymbol = mCurrentSymbol;
+    return checkpoint;
+}
+
+void Lexer::restore(const Checkpoint& checkpoint) {
+    assert(checkpoint.mLocation >= mBufferOffset and "checkpoint no longer in the stream window");
+
+    mBufferIt = mBuffer.data() + (checkpoint.mLocation - mBufferOffset);
+    mTokenIt = mBuffer.data() + (std::max(checkpoint.mTokenOffset, mBufferOffset) - mBufferOffset);
+    mTokenOffset = checkpoint.mTokenOffset;
+    mCurrentInt = checkpoint.mInt;
+    mCurrentFloat = checkpoint.mFloat;
+    mCurrentStr = checkpoint.mStr;
+    mCurrentSymbol = checkpoint.mSymbol;
+    mPendingError.reset();
+}
+
+void Lexer::internCurrentStr() {
+    if (!mSpeculative)
+        mCurrentSymbol = SymbolPool::global().intern(mCurrentStr);
+}
+
+void Lexer::parseInt(const char* begin, const char* end) {
+    if (std::from_chars(begin, end, mCurrentInt).ec == std::errc::result_out_of_range) {
+        mCurrentInt = 0;
+        reportError(ErrorLogger::ErrorType::NUMBER_OUT_OF_RANGE);
     }
-    return false;
+}
+
+void Lexer::parseFloat(const char* begin, const char* end) {
+    // Parses the longest valid prefix, so "1.x" is 1 and "1.e5" is 100000
+    if (std::from_chars(begin, end, mCurrentFloat).ec == std::errc::result_out_of_range) {
+        mCurrentFloat = 0;
+        reportError(ErrorLogger::ErrorType::NUMBER_OUT_OF_RANGE);
+    }
+}
+
+void Lexer::reportError(ErrorLogger::ErrorType type) {
+    mPendingError = type;
+    mPendingErrorLocation = GetCurrentLocation();
+}
+
+void Lexer::refillWindow(const char* keep) {
+    const std::size_t position = mBufferIt - keep;
+
+    mStream->refill(keep);
+    mBuffer = std::string_view(mStream->data(), mStream->size());
+    mBufferOffset = mStream->getOffset();
+    mBufferIt = mBuffer.data() + position;
+    mBufferEnd = mBuffer.data() + mBuffer.size();
+    mTokenIt = mBuffer.data();
 }
 
 char Lexer::advance() {
-    mSrcLoc.advance(*mBufferIt == '\n');
+    // The buffer may be a mapping with nothing readable past its end
+    if (mBufferIt == mBufferEnd) return 0;
+
     ++mBufferIt;
-    if (mBufferIt == mBuffer.end()) return 0;
+    if (mBufferIt == mBufferEnd) return 0;
     return *mBufferIt;
 }
 
-Lexer::Token Lexer::getNextTokenAndComment() {
-    while (mBufferIt != mBuffer.end() && isspace(*mBufferIt)) {
+void Lexer::advanceTo(const char* target) {
+    mBufferIt = target;
+}
+
+void Lexer::skipPast(char end) {
+    advanceTo(std::find(mBufferIt, mBufferEnd, end));
+    if (mBufferIt != mBufferEnd)
         advance();
+    else
+        mRecoveryEnd = end;
+}
+
+Lexer::Token Lexer::getNextTokenAndComment() {
+    mRecoveryEnd = 0;
+    Token token = lexBackend();
+    mTokenOffset = mBufferOffset + (mTokenIt - mBuffer.data());
+
+    // A token that runs into the end of a stream window may continue in input not read yet
+    while (mStream and mBufferIt == mBufferEnd and !mStream->isExhausted()) {
+        if (token == Token::COMMENT) {
+            // No payload to keep, so a comment never needs more than one window
+            refillWindow(mBufferEnd);
+            advanceTo(Scan::findNewline(mBufferIt, mBufferEnd));
+            continue;
+        }
+
+        if (mRecoveryEnd != 0) {
+            // Skipped bytes are not kept either. The error is reported first, while its location is in the window
+            if (mPendingError and !mSpeculative) {
+                ErrorLogger::printErrorAtLocation(*mPendingError, getLineColumn(mPendingErrorLocation));
+                mPendingError.reset();
+            }
+            refillWindow(mBufferEnd);
+            skipPast(std::exchange(mRecoveryEnd, 0));
+            if (mRecoveryEnd == 0)
+                break;
+            continue;
+        }
+
+        // Lex the token again once the rest of it is in the window
+        mPendingError.reset();
+        mBufferIt = mTokenIt;
+        refillWindow(mTokenIt);
+        token = lexBackend();
+        mTokenOffset = mBufferOffset + (mTokenIt - mBuffer.data());
     }
 
+    if (mPendingError and !mSpeculative) {
+        ErrorLogger::printErrorAtLocation(*mPendingError, getLineColumn(mPendingErrorLocation));
+        mPendingError.reset();
+    }
+
+    return token;
+}
+
+Lexer::Token Lexer::lexHandwritten() {
+    advanceTo(Scan::skipWhitespace(mBufferIt, mBufferEnd));
+
+    mTokenIt = mBufferIt;
+
     // End of file, we're done
-    if (mBufferIt == mBuffer.end())
+    if (mBufferIt == mBufferEnd)
         return Token::TOK_EOF;
 
     const char currentChar = *mBufferIt;
@@ -167,8 +323,7 @@ Lexer::Token Lexer::getNextTokenAndComment() {
         case '/':
             if (advance() == '/') {
                 // A comment covers a whole line
-                while (mBufferIt != mBuffer.end() && *mBufferIt != '\n')
-                    advance();
+                advanceTo(Scan::findNewline(mBufferIt, mBufferEnd));
                 return Token::COMMENT;
             } else {
                 return Token::OP_DIV;
@@ -193,148 +348,223 @@ Lexer::Token Lexer::getNextTokenAndComment() {
                 advance();
                 return Token::OP_NE;
             } else {
-                ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::INVALID_SYMBOL, mSrcLoc);
+                reportError(ErrorLogger::ErrorType::INVALID_SYMBOL);
                 return Token::UNKNOWN;  // TODO: Add the Not operator?
             }
 
-        case '\"':
-            mCurrentStr.clear();
-            while ((advance() != 0) && (*mBufferIt != '\n') && (*mBufferIt != '\"'))
-                mCurrentStr += *mBufferIt;
+        case '\"': {
+            const char* strBegin = mBufferIt + 1;
+            advanceTo(Scan::findStringEnd(strBegin, mBufferEnd));
+            mCurrentStr = std::string_view(strBegin, mBufferIt - strBegin);
 
-            if (mBufferIt == mBuffer.end()) {  // Buffer Ended before closing string
-                ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::MISSING_CLOSING_QUOTE, mSrcLoc);
+            if (mBufferIt == mBufferEnd) {  // Buffer Ended before closing string
+                reportError(ErrorLogger::ErrorType::MISSING_CLOSING_QUOTE);
                 return Token::UNKNOWN;
             } else if (*mBufferIt == '\n') {  // Line Ended before closing string
-                ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::NEW_LINE_IN_LITERAL, mSrcLoc);
-
-                while ((mBufferIt != mBuffer.end()) && (*mBufferIt != '\"'))
-                    advance();
+                reportError(ErrorLogger::ErrorType::NEW_LINE_IN_LITERAL);
+                skipPast('\"');
+                return Token::UNKNOWN;
+            } else if (const char* invalid = Unicode::validate(strBegin, mBufferIt); invalid != mBufferIt) {
+                const char* strEnd = mBufferIt;
+                advanceTo(invalid);
+                reportError(ErrorLogger::ErrorType::INVALID_UTF8);
 
+                advanceTo(strEnd);
                 advance();
-
                 return Token::UNKNOWN;
             } else {  // String Found!
                 advance();
+                internCurrentStr();
                 return Token::STR_LITERAL;
             }
+        }
 
         default:
-            if (isalpha(currentChar) or currentChar == '_') {
-                mCurrentStr = currentChar;
-                while (advance() != 0 and (isalnum(*mBufferIt) or *mBufferIt == '_')) {
-                    mCurrentStr += *mBufferIt;
-                }
-
-                return tokenizeCurrentStr();
+            if (Unicode::isIdentifierStart(currentChar)) {
+                return lexIdentifier(1);
             }
 
-            else if (isdigit(currentChar)) {
-                std::string numberStr;
-                do {
-                    numberStr += *mBufferIt;
-                } while (isdigit(advance()));
+            else if (Unicode::isDigit(currentChar)) {
+                const char* numberBegin = mBufferIt;
+                while (Unicode::isDigit(advance()))
+                    ;
 
-                if (*mBufferIt == '.') {
-                    numberStr += *mBufferIt;
+                if (current() == '.') {
+                    // The byte after the dot always belongs to the literal
                     advance();
+                    while (Unicode::isDigit(advance()))
+                        ;
 
-                    do {
-                        numberStr += *mBufferIt;
-                    } while (isdigit(advance()));
-
-                    mCurrentFloat = std::stof(numberStr);
+                    parseFloat(numberBegin, mBufferIt);
                     return Token::FLOAT_LITERAL;
                 }
 
-                else if (isalpha(*mBufferIt)) {
-                    ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::NUMBER_BAD_SUFFIX, mSrcLoc);
-
-                    while ((mBufferIt != mBuffer.end()) and (*mBufferIt != ';'))
-                        advance();
-
-                    if (mBufferIt != mBuffer.end())
-                        advance();
-
+                else if (Unicode::isLetter(current())) {
+                    reportError(ErrorLogger::ErrorType::NUMBER_BAD_SUFFIX);
+                    skipPast(';');
                     return Token::UNKNOWN;
                 }
 
                 else {
-                    mCurrentInt = std::stoi(numberStr);
+                    parseInt(numberBegin, mBufferIt);
                     return Token::INT_LITERAL;
                 }
-            } else {
+            }
+
+            else if (!Unicode::isAscii(currentChar)) {
+                const Unicode::Decoded decoded = Unicode::decode(mBufferIt, mBufferEnd);
+                if (decoded.valid and Unicode::isXidStart(decoded.codePoint))
+                    return lexIdentifier(decoded.length);
+
+                // A sequence cut by the end of a stream window ends at mBufferEnd and is lexed again
+                advanceTo(mBufferIt + decoded.length);
+                reportError(decoded.valid ? ErrorLogger::ErrorType::INVALID_SYMBOL : ErrorLogger::ErrorType::INVALID_UTF8);
+                return Token::UNKNOWN;
+            }
+
+            else {
                 advance();
-                ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::INVALID_SYMBOL, mSrcLoc);
+                reportError(ErrorLogger::ErrorType::INVALID_SYMBOL);
                 return Token::UNKNOWN;
             }
     }
 
-    ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::INVALID_SYMBOL, mSrcLoc);
+    reportError(ErrorLogger::ErrorType::INVALID_SYMBOL);
     return Token::UNKNOWN;
 }
 
+Lexer::Token Lexer::lexIdentifier(unsigned startLength) {
+    const char* strBegin = mBufferIt;
+    advanceTo(mBufferIt + startLength);
+
+    for (;;) {
+        while (mBufferIt != mBufferEnd and Unicode::isIdentifierContinue(*mBufferIt))
+            ++mBufferIt;
+        if (mBufferIt == mBufferEnd or Unicode::isAscii(*mBufferIt))
+            break;
+
+        const Unicode::Decoded decoded = Unicode::decode(mBufferIt, mBufferEnd);
+        if (!decoded.valid and mBufferIt + decoded.length == mBufferEnd and mStream and !mStream->isExhausted()) {
+            // The next code point is cut by the end of the window, lex again once it is read
+            advanceTo(mBufferEnd);
+            return Token::UNKNOWN;
+        }
+        if (!decoded.valid or !Unicode::isXidContinue(decoded.codePoint))
+            break;
+
+        advanceTo(mBufferIt + decoded.length);
+    }
+
+    mCurrentStr = std::string_view(strBegin, mBufferIt - strBegin);
+    return tokenizeCurrentStr();
+}
+
 Lexer::Token Lexer::getNextToken() {
     Token current = getNextTokenAndComment();
     while (current == Lexer::Token::COMMENT) {
         current = getNextTokenAndComment();
     }
 
-#ifndef NDEBUG
-    std::cout << "Returning Token: " << Lexer::token_to_str[(size_t)current] << "\n";
-#endif
+    if constexpr (Trace::enabled)
+        Trace::local().token(current, mTokenOffset, getCurrentTokenLength());
 
     return current;
 }
 
+TokenTable Lexer::lexAll(bool keepComments) {
+    TokenTable tokens(mSource);
+    // Typical sources average a little over four bytes per token
+    tokens.reserve((mBufferEnd - mBufferIt) / 4 + 1);
+
+    Token current;
+    do {
+        current = getNextTokenAndComment();
+        pushCurrentToken(tokens, current, keepComments);
+    } while (current != Token::TOK_EOF);
+
+    return tokens;
+}
+
+void Lexer::pushCurrentToken(TokenTable& tokens, Token token, bool keepComments) {
+    const std::uint64_t offset = getCurrentTokenOffset();
+    const std::uint64_t length = getCurrentTokenLength();
+
+    switch (token) {
+        case Token::COMMENT:
+            if (keepComments)
+                tokens.push(token, offset, length);
+            break;
+        case Token::INT_LITERAL:
+            tokens.pushInt(token, offset, length, mCurrentInt);
+            break;
+        case Token::FLOAT_LITERAL:
+            tokens.pushFloat(token, offset, length, mCurrentFloat);
+            break;
+        case Token::IDENTIFIER:
+        case Token::STR_LITERAL:
+            tokens.pushSymbol(token, offset, length, mCurrentSymbol);
+            break;
+        default:
+            tokens.push(token, offset, length);
+            break;
+    }
+}
+
+bool Lexer::relex(TokenTable& tokens, const TextEdit& edit, bool keepComments) {
+    const std::string_view old = tokens.getSource();
+    if (tokens.empty() or !tokens.getSourceBuffer() or edit.offset > old.size() or edit.length > old.size() - edit.offset)
+        return false;
+
+    init(SourceBuffer::edit(*tokens.getSourceBuffer(), edit.offset, edit.length, edit.text));
+
+    // A token only depends on its bytes and the code point after it, at most four bytes, so tokens ending
+    // at least that far in front of the edit are unchanged, and lexing resumes from the end of the last of them
+    std::size_t first = 0;
+    for (std::size_t count = tokens.size(); count > 0;) {
+        const std::size_t half = count / 2;
+        if (tokens.getOffset(first + half) + tokens.getLength(first + half) + 4 <= edit.offset) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    if (first > 0)
+        advanceTo(mBuffer.data() + tokens.getOffset(first - 1) + tokens.getLength(first - 1));
+
+    // Past the edit the text is the old one shifted by delta, and the lexer never looks back: once a
+    // token starts where an old one did, every later token is the old one shifted
+    const std::int64_t delta = (std::int64_t)edit.text.size() - (std::int64_t)edit.length;
+    const std::uint64_t editEnd = edit.offset + edit.text.size();
+    TokenTable relexed;
+    std::size_t last = first;
+    for (;;) {
+        const Token current = getNextTokenAndComment();
+        if (mTokenOffset >= editEnd) {
+            const std::uint64_t oldOffset = mTokenOffset - delta;
+            while (last < tokens.size() and tokens.getOffset(last) < oldOffset) ++last;
+            if (last < tokens.size() and tokens.getOffset(last) == oldOffset)
+                break;
+        }
+
+        pushCurrentToken(relexed, current, keepComments);
+        if (current == Token::TOK_EOF) {
+            last = tokens.size();
+            break;
+        }
+    }
+
+    tokens.splice(first, last, relexed, delta, mSource);
+
+    mBufferIt = mBufferEnd;
+    mTokenIt = mBufferEnd;
+    mTokenOffset = mBufferEnd - mBuffer.data();
+    return true;
+}
+
 Lexer::Token Lexer::tokenizeCurrentStr() {
-    if (mCurrentStr == "i32")
-        return Token::KW_INT_32;
-    else if (mCurrentStr == "i64")
-        return Token::KW_INT_64;
-    else if (mCurrentStr == "u32")
-        return Token::KW_UINT_32;
-    else if (mCurrentStr == "u64")
-        return Token::KW_UINT_64;
-    else if (mCurrentStr == "f32")
-        return Token::KW_FLOAT_32;
-    else if (mCurrentStr == "f64")
-        return Token::KW_FLOAT_64;
-    else if (mCurrentStr == "string")
-        return Token::KW_STRING;
-    else if (mCurrentStr == "bool")
-        return Token::KW_BOOL;
-    else if (mCurrentStr == "void")
-        return Token::KW_VOID;
-    else if (mCurrentStr == "true")
-        return Token::KW_TRUE;
-    else if (mCurrentStr == "false")
-        return Token::KW_FALSE;
-    else if (mCurrentStr == "let")
-        return Token::KW_LET;
-
-    else if (mCurrentStr == "if")
-        return Token::KW_IF;
-    else if (mCurrentStr == "elif")
-        return Token::KW_ELIF;
-    else if (mCurrentStr == "else")
-        return Token::KW_ELSE;
-    else if (mCurrentStr == "for")
-        return Token::KW_FOR;
-    else if (mCurrentStr == "in")
-        return Token::KW_IN;
-    else if (mCurrentStr == "while")
-        return Token::KW_WHILE;
-
-    else if (mCurrentStr == "fn")
-        return Token::KW_FN;
-    else if (mCurrentStr == "return")
-        return Token::KW_RETURN;
-
-    else if (mCurrentStr == "and")
-        return Token::OP_AND;
-    else if (mCurrentStr == "or")
-        return Token::OP_OR;
-    else
-        return Token::IDENTIFIER;
+    const Token token = Keywords::classify(mCurrentStr);
+    if (token == Token::IDENTIFIER)
+        internCurrentStr();
+    return token;
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include <CFG/cfg.hpp>
+#include <CFG/misc.hpp>
+#include <cstdint>
+#include <iterator>
+#include <parser/expressionbuilder.hpp>
+#include <parser/lltables.hpp>
+#include <parser/parser.hpp>
+#include <parser/trace.hpp>
+#include <vector>
+
+using namespace Crust;
+
+namespace {
+
+/*
+ * \class Frame
+ * \brief An entry of the parse stack: a terminal to match, a rule to expand, or the node of an
+ * expanded rule to build once its children are parsed
+ */
+struct Frame {
+    enum class Action : std::uint8_t { MATCH, EXPAND, BUILD };
+
+    Action action;
+    std::uint8_t index; /*!< Of the terminal or of the rule */
+    std::uint32_t base; /*!< For BUILD, the number of values below the children of the node */
+};
+
+std::unique_ptr<CFGNode> errorNode() { return std::make_unique<CFGNode>(CFGNode::NodeKind::ERROR, "ERROR"); }
+
+// The terms and operators of an EXPRESSION, folded like Parser::parseExpression does
+ChildrenNode foldOperators(ChildrenNode&& items) {
+    ExpressionBuilder builder;
+    builder.pushOperand(std::move(items[0]));
+    for (std::size_t idx = 1; idx + 1 < items.size(); idx += 2) {
+        builder.pushOperator(static_cast<const Token&>(*items[idx]).getToken(), std::move(items[idx]));
+        builder.pushOperand(std::move(items[idx + 1]));
+    }
+
+    ChildrenNode folded;
+    folded.push_back(builder.finish());
+    return folded;
+}
+
+}  // namespace
+
+std::unique_ptr<CFGNode> Parser::parseProgramTable() {
+    // Rules that nest, like segments or parenthesized expressions, only grow these vectors
+    std::vector<Frame> stack{{Frame::Action::EXPAND, LLTables::START, 0}};
+    ChildrenNode values;
+
+    while (!stack.empty()) {
+        const Frame frame = stack.back();
+        stack.pop_back();
+
+        switch (frame.action) {
+            case Frame::Action::MATCH:
+                values.push_back(parseToken(LLTables::terminals[frame.index]));
+                break;
+
+            case Frame::Action::BUILD: {
+                const LLTables::Rule& rule = LLTables::rules[frame.index];
+                ChildrenNode children(std::make_move_iterator(values.begin() + frame.base),
+                                      std::make_move_iterator(values.end()));
+                values.resize(frame.base);
+                if (rule.kind == CFGNode::NodeKind::EXPRESSION)
+                    children = foldOperators(std::move(children));
+                values.push_back(std::make_unique<CFGNode>(rule.kind, rule.name, std::move(children)));
+
+                if constexpr (Trace::enabled)
+                    Trace::local().exitRule(rule.kind, currentLocation().getOffset());
+                break;
+            }
+
+            case Frame::Action::EXPAND: {
+                const LLTables::Rule& rule = LLTables::rules[frame.index];
+                if constexpr (Trace::enabled)
+                    if (!rule.spliced)
+                        Trace::local().enterRule(rule.kind, currentLocation().getOffset());
+
+                skipUntil(rule.skip, rule.error);
+
+                std::uint8_t production = LLTables::predict[frame.index * LLTables::NUM_TOKENS + (std::size_t)mCurrentToken];
+                if (production != LLTables::NO_PRODUCTION and production >= LLTables::CONFLICT)
+                    production = LLTables::second[(production - LLTables::CONFLICT) * LLTables::NUM_TOKENS + (std::size_t)peek(1)];
+
+                if (production == LLTables::NO_PRODUCTION) {
+                    // Like the parse functions, return an empty node if the rule may be empty and an ERROR otherwise
+                    if (!rule.spliced) {
+                        values.push_back(rule.nullable ? std::make_unique<CFGNode>(rule.kind, rule.name) : errorNode());
+                        if constexpr (Trace::enabled)
+                            Trace::local().exitRule(rule.kind, currentLocation().getOffset());
+                    } else if (!rule.nullable) {
+                        values.push_back(errorNode());
+                    }
+                    break;
+                }
+
+                if (!rule.spliced)
+                    stack.push_back({Frame::Action::BUILD, frame.index, (std::uint32_t)values.size()});
+
+                // Pushed last to first, so the first symbol is on top
+                for (std::size_t idx = LLTables::productions[production + 1]; idx-- > LLTables::productions[production];) {
+                    const std::uint8_t symbol = LLTables::symbols[idx];
+                    if (symbol < LLTables::NUM_TERMINALS)
+                        stack.push_back({Frame::Action::MATCH, symbol, 0});
+                    else
+                        stack.push_back({Frame::Action::EXPAND, (std::uint8_t)(symbol - LLTables::NUM_TERMINALS), 0});
+                }
+                break;
+            }
+        }
+    }
+
+    return std::move(values.back());
+}
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <bit>
+#include <common/errorlogger.hpp>
+#include <common/symbolpool.hpp>
+#include <optional>
+#include <parser/lexer.hpp>
+#include <parser/scan.hpp>
+#include <parser/tokentable.hpp>
+#include <thread>
+#include <vector>
+
+using namespace Crust;
+
+/*
+ * Parallel lexing
+ *
+ * The buffer is cut right after newlines into one chunk per thread and every chunk is lexed from
+ * its first byte as if a token started there. The lexer keeps no state between tokens, so the
+ * tokens lexed from a position only depend on that position: once the sequential token stream and
+ * a chunk agree on the start of one token, they agree on every later token of the chunk.
+ *
+ * A chunk is wrong to start from when a token of the previous chunk runs into it, which happens for
+ * a string cut by a newline (the recovery skips to the next quote), a number with a bad suffix (the
+ * recovery skips to the next ';') and a float whose dot is the last byte of the line. The merge
+ * walks the chunks in order, and wherever the previous token ends past the start of a chunk it lexes
+ * sequentially until it reaches a token start that the chunk also found. Comments end before the
+ * newline and never cross a chunk boundary.
+ *
+ * Workers neither intern nor report, they only hash the symbol text. Symbols are interned and errors
+ * printed by the merge, in token order, so the table and the diagnostics are exactly those of lexAll.
+ */
+
+struct Lexer::Chunk {
+    const char* begin;
+    const char* end; /*!< Tokens starting before end belong to the chunk */
+    std::vector<SpeculativeToken> tokens;
+    std::vector<SpeculativeError> errors;
+};
+
+Lexer::SpeculativeToken Lexer::takeToken(Token token) const {
+    std::uint64_t value = 0;
+    if (token == Token::IDENTIFIER or token == Token::STR_LITERAL)
+        value = SymbolPool::hash(mCurrentStr);
+    else if (token == Token::INT_LITERAL)
+        value = mCurrentInt;
+    else if (token == Token::FLOAT_LITERAL)
+        value = std::bit_cast<std::uint64_t>(mCurrentFloat);
+
+    return {token, mTokenOffset, getCurrentTokenLength(), value};
+}
+
+Symbol Lexer::internToken(const SpeculativeToken& token, std::string_view source) {
+    if (token.kind == Token::STR_LITERAL) {
+        // Without the quotes, or the NUL byte closing the string
+        return SymbolPool::global().intern(source.substr(token.offset + 1, token.length - 2), (std::uint32_t)token.value);
+    }
+    return SymbolPool::global().intern(source.substr(token.offset, token.length), (std::uint32_t)token.value);
+}
+
+void Lexer::lexChunk(Chunk& chunk) {
+    const bool last = chunk.end == mBufferEnd;
+    mBufferIt = chunk.begin;
+    // Typical sources average a little over four bytes per token
+    chunk.tokens.reserve((chunk.end - chunk.begin) / 4 + 1);
+
+    for (;;) {
+        const Token token = getNextTokenAndComment();
+        if (!last and mTokenIt >= chunk.end)
+            break;
+
+        if (mPendingError) {
+            chunk.errors.push_back({chunk.tokens.size(), *mPendingError, mPendingErrorLocation});
+            mPendingError.reset();
+        }
+        chunk.tokens.push_back(takeToken(token));
+        if (token == Token::TOK_EOF)
+            break;
+    }
+}
+
+std::size_t Lexer::relexChunk(const Chunk& chunk, const char*& resume, TokenTable& tokens, bool keepComments) {
+    const bool last = chunk.end == mBufferEnd;
+    std::size_t next = 0;
+    mBufferIt = resume;
+
+    for (;;) {
+        const Token token = getNextTokenAndComment();
+        if (!last and mTokenIt >= chunk.end) {
+            mPendingError.reset();
+            return chunk.tokens.size();
+        }
+
+        // Back in step with the speculation, the chunk is right from this token on
+        while (next < chunk.tokens.size() and chunk.tokens[next].offset < mTokenOffset) ++next;
+        if (next < chunk.tokens.size() and chunk.tokens[next].offset == mTokenOffset) {
+            mPendingError.reset();
+            return next;
+        }
+
+        if (mPendingError) {
+            ErrorLogger::printErrorAtLocation(*mPendingError, getLineColumn(mPendingErrorLocation));
+            mPendingError.reset();
+        }
+        emitToken(takeToken(token), tokens, keepComments);
+        resume = mBufferIt;
+        if (token == Token::TOK_EOF)
+            return chunk.tokens.size();
+    }
+}
+
+void Lexer::emitToken(const SpeculativeToken& token, TokenTable& tokens, bool keepComments) const {
+    switch (token.kind) {
+        case Token::COMMENT:
+            if (keepComments)
+                tokens.push(token.kind, token.offset, token.length);
+            break;
+        case Token::INT_LITERAL:
+            tokens.pushInt(token.kind, token.offset, token.length, token.value);
+            break;
+        case Token::FLOAT_LITERAL:
+            tokens.pushFloat(token.kind, token.offset, token.length, std::bit_cast<double>(token.value));
+            break;
+        case Token::IDENTIFIER:
+        case Token::STR_LITERAL:
+            tokens.pushSymbol(token.kind, token.offset, token.length, internToken(token, mBuffer));
+            break;
+        default:
+            tokens.push(token.kind, token.offset, token.length);
+            break;
+    }
+}
+
+TokenTable Lexer::lexAllParallel(unsigned threads, bool keepComments, std::size_t minChunkSize) {
+    const std::size_t size = mBufferEnd - mBufferIt;
+    threads = std::min<std::size_t>(threads, size / std::max<std::size_t>(minChunkSize, 1));
+    if (mStream or threads < 2)
+        return lexAll(keepComments);
+
+    // Every chunk but the first starts right after a newline
+    std::vector<Chunk> chunks;
+    const char* begin = mBufferIt;
+    for (unsigned i = 1; i <= threads; ++i) {
+        const char* end = i == threads ? mBufferEnd : Scan::findNewline(mBufferIt + size * i / threads, mBufferEnd);
+        if (end != mBufferEnd)
+            ++end;
+        if (end <= begin)
+            continue;
+
+        chunks.push_back(Chunk{begin, end, {}, {}});
+        begin = end;
+    }
+
+    Lexer speculative(*this);
+    speculative.mSpeculative = true;
+    speculative.mPendingError.reset();
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < chunks.size(); ++i)
+        workers.emplace_back([worker = speculative, &chunk = chunks[i]]() mutable { worker.lexChunk(chunk); });
+    Lexer(speculative).lexChunk(chunks.front());
+    for (auto& worker : workers) worker.join();
+
+    TokenTable tokens(mSource);
+    tokens.reserve(size / 4 + 1);
+
+    // Merge in order, lexing again wherever the previous token ended inside the chunk
+    Lexer sequential(speculative);
+    const char* resume = mBufferIt;  // End of the last token emitted
+    for (const Chunk& chunk : chunks) {
+        std::size_t next = 0;
+        if (resume > chunk.begin)
+            next = sequential.relexChunk(chunk, resume, tokens, keepComments);
+
+        auto error = std::lower_bound(chunk.errors.begin(), chunk.errors.end(), next,
+                                      [](const SpeculativeError& error, std::size_t token) { return error.token < token; });
+        for (; next < chunk.tokens.size(); ++next) {
+            if (error != chunk.errors.end() and error->token == next) {
+                ErrorLogger::printErrorAtLocation(error->type, getLineColumn(error->location));
+                ++error;
+            }
+            emitToken(chunk.tokens[next], tokens, keepComments);
+            resume = mBuffer.data() + chunk.tokens[next].offset + chunk.tokens[next].length;
+        }
+    }
+
+    mBufferIt = mBufferEnd;
+    mTokenIt = mBufferEnd;
+    mTokenOffset = mBufferEnd - mBuffer.data();
+    return tokens;
+}
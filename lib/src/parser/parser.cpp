@@ -1,19 +1,83 @@
 #include <CFG/cfg.hpp>
+#include <CFG/first.hpp>
+#include <cassert>
 #include <common/errorlogger.hpp>
 #include <iostream>
+#include <parser/expressionbuilder.hpp>
 #include <parser/parser.hpp>
+#include <parser/tokentable.hpp>
+#include <parser/trace.hpp>
 
 namespace Crust {
 
 void Parser::skipToNextSemiColon() {
     while (mCurrentToken != Lexer::Token::TOK_EOF and mCurrentToken != Lexer::Token::SEMI_COLON) {
-        mCurrentToken = mLexer.getNextToken();
+        mCurrentToken = nextToken();
     }
 }
 
-Lexer::Token Parser::peekNextToken() {
-    Lexer lexer_copy = mLexer;
-    return lexer_copy.getNextToken();
+void Parser::skipUntil(TokenSet expected, ErrorLogger::ErrorType error) {
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !expected.contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(error, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
+    }
+}
+
+Lexer::Token Parser::nextToken() {
+    if (mTokens) {
+        if (mTokenIdx + 1 < mTokens->size())
+            ++mTokenIdx;
+        return mTokens->getKind(mTokenIdx);
+    }
+
+    if (mLookaheadSize == 0) {
+        mCurrent = lexToken();
+    } else {
+        mCurrent = mLookahead[mLookaheadBegin];
+        mLookaheadBegin = (mLookaheadBegin + 1) & (LOOKAHEAD - 1);
+        --mLookaheadSize;
+    }
+
+    return mCurrent.kind;
+}
+
+Lexer::Token Parser::peek(std::size_t k) {
+    assert(k >= 1 and k <= LOOKAHEAD);
+
+    if (mTokens) {
+        return mTokenIdx + k < mTokens->size() ? mTokens->getKind(mTokenIdx + k) : Lexer::Token::TOK_EOF;
+    }
+
+    // Filled lazily, the lexer keeps returning TOK_EOF past the end
+    for (; mLookaheadSize < k; ++mLookaheadSize)
+        mLookahead[(mLookaheadBegin + mLookaheadSize) & (LOOKAHEAD - 1)] = lexToken();
+
+    return mLookahead[(mLookaheadBegin + k - 1) & (LOOKAHEAD - 1)].kind;
+}
+
+LexedToken Parser::lexToken() {
+    if (mPipeline)
+        return mPipeline->next();
+
+    return LexedToken::fromLexer(mLexer, mLexer.getNextToken());
+}
+
+const SourceBuffer& Parser::currentSource() const {
+    return mTokens ? *mTokens->getSourceBuffer() : *mLexer.getSourceBuffer();
+}
+
+SourceLocation Parser::currentLocation() const {
+    return mTokens ? mTokens->getEndLocation(mTokenIdx) : SourceLocation(mCurrent.offset + mCurrent.length);
+}
+
+Parser::RuleTrace::RuleTrace(const Parser& parser, CFGNode::NodeKind rule) : mParser{parser}, mRule{rule} {
+    if constexpr (Trace::enabled)
+        Trace::local().enterRule(mRule, mParser.currentLocation().getOffset());
+}
+
+Parser::RuleTrace::~RuleTrace() {
+    if constexpr (Trace::enabled)
+        Trace::local().exitRule(mRule, mParser.currentLocation().getOffset());
 }
 
 std::unique_ptr<CFGNode> Parser::parseProgram(const std::string& filename) {
@@ -23,133 +87,133 @@ std::unique_ptr<CFGNode> Parser::parseProgram(const std::string& filename) {
         return nullptr;
     }
 
-    mCurrentToken = mLexer.getNextToken();
-    return parseProgramDecl();
+    mTokens = nullptr;
+    mLookaheadSize = 0;
+    if (mPipelined)
+        mPipeline = std::make_unique<TokenPipeline>(mLexer.getSourceBuffer());
+
+    mCurrentToken = nextToken();
+    auto program = parseBackend();
+    mPipeline = nullptr;
+    return program;
+}
+
+std::unique_ptr<CFGNode> Parser::parseProgram(const TokenTable& tokens) {
+    if (tokens.empty()) {
+        return nullptr;
+    }
+
+    mTokens = &tokens;
+    mTokenIdx = 0;
+    mCurrentToken = tokens.getKind(0);
+
+    auto program = parseBackend();
+    mTokens = nullptr;
+    return program;
 }
 
 std::unique_ptr<ProgDecl> Parser::parseProgramDecl() {
-    auto progDeclNode = std::make_unique<ProgDecl>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::PROG_DECL);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and progDeclNode->first.find(mCurrentToken) == progDeclNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::EXPECTED_DECL, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::PROG_DECL).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::EXPECTED_DECL, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     std::unique_ptr<Crust::DeclList> declList = parseDeclList();
-    progDeclNode.reset(new ProgDecl(std::move(declList)));
-
-    return progDeclNode;
+    return std::make_unique<ProgDecl>(std::move(declList));
 }
 
 std::unique_ptr<DeclList> Parser::parseDeclList() {
-    auto declListNode = std::make_unique<DeclList>();
-
-    while (mCurrentToken != Lexer::Token::TOK_EOF and declListNode->first.find(mCurrentToken) == declListNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::EXPECTED_DECL, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
-    }
+    const RuleTrace trace(*this, CFGNode::NodeKind::DECL_LIST);
 
-    if (mCurrentToken == Lexer::Token::TOK_EOF) {
-    } else {
-        std::unique_ptr<Crust::Decl> decl = parseDecl();
-        std::unique_ptr<Crust::DeclList> declList = parseDeclList();
-        declListNode.reset(new DeclList(std::move(decl), std::move(declList)));
+    ChildrenNode decls;
+    for (;;) {
+        skipUntil(FirstSets::get(CFGNode::NodeKind::DECL_LIST), ErrorLogger::ErrorType::EXPECTED_DECL);
+        if (mCurrentToken == Lexer::Token::TOK_EOF)
+            break;
+        decls.push_back(parseDecl());
     }
 
-    return declListNode;
+    return std::make_unique<DeclList>(std::move(decls));
 }
 
 std::unique_ptr<Decl> Parser::parseDecl() {
-    auto declNode = std::make_unique<Decl>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::DECL);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and declNode->first.find(mCurrentToken) == declNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::EXPECTED_DECL, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::DECL).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::EXPECTED_DECL, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::KW_FN) {
         std::unique_ptr<Crust::FnDecl> fnDecl = parseFnDecl();
-        declNode.reset(new Decl(std::move(fnDecl)));
+        return std::make_unique<Decl>(std::move(fnDecl));
     }
 
     else if (mCurrentToken == Lexer::Token::LBRACKET or (mCurrentToken >= Lexer::Token::KW_INT_32 and mCurrentToken <= Lexer::Token::KW_VOID)) {
         std::unique_ptr<Crust::VarDecl> varDecl = parseVarDecl();
         std::unique_ptr<Crust::Token> semi_colon = parseToken(Lexer::Token::SEMI_COLON);
 
-        declNode.reset(
-            new Decl(
-                std::move(varDecl),
-                std::move(semi_colon)));
+        return std::make_unique<Decl>(
+            std::move(varDecl),
+            std::move(semi_colon));
     }
 
-    return declNode;
+    return std::make_unique<Decl>();
 }
 
 std::unique_ptr<VarDecl> Parser::parseVarDecl() {
-    auto varDeclNode = std::make_unique<VarDecl>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::VAR_DECL);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and varDeclNode->first.find(mCurrentToken) == varDeclNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::EXPECTED_DECL, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::VAR_DECL).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::EXPECTED_DECL, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::LBRACKET or (mCurrentToken >= Lexer::Token::KW_INT_32 and mCurrentToken <= Lexer::Token::KW_VOID)) {
         std::unique_ptr<Crust::Type> type = parseType();
         std::unique_ptr<Crust::VarDeclList> varDeclList = parseVarDeclList();
-        varDeclNode.reset(new VarDecl(std::move(type),
-                                      std::move(varDeclList)));
+        return std::make_unique<VarDecl>(std::move(type),
+                                         std::move(varDeclList));
     }
 
-    return varDeclNode;
+    return std::make_unique<VarDecl>();
 }
 
 std::unique_ptr<VarDeclList> Parser::parseVarDeclList() {
-    auto varDeclListNode = std::make_unique<VarDeclList>();
-
-    while (mCurrentToken != Lexer::Token::TOK_EOF and varDeclListNode->first.find(mCurrentToken) == varDeclListNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::MISSING_SEMI_COLON, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
-    }
-
-    if (mCurrentToken == Lexer::Token::IDENTIFIER) {
-        std::unique_ptr<Token> identifier = parseToken(Lexer::Token::IDENTIFIER);
-        std::unique_ptr<VarDeclList_> varDeclList_ = parseVarDeclList_();
-
-        varDeclListNode.reset(new VarDeclList(
-            std::move(identifier),
-            std::move(varDeclList_)));
-    }
-
-    return varDeclListNode;
-}
-
-std::unique_ptr<VarDeclList_> Parser::parseVarDeclList_() {
-    auto varDeclList_Node = std::make_unique<VarDeclList_>();
-
-    while (mCurrentToken != Lexer::Token::TOK_EOF and varDeclList_Node->first.find(mCurrentToken) == varDeclList_Node->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
-    }
-
-    if (mCurrentToken == Lexer::Token::COMMA) {
-        std::unique_ptr<Token> comma = parseToken(Lexer::Token::COMMA);
-        std::unique_ptr<VarDeclList> varDeclList = parseVarDeclList();
-
-        varDeclList_Node.reset(new VarDeclList_(
-            std::move(comma),
-            std::move(varDeclList)));
-    } else if (mCurrentToken == Lexer::Token::SEMI_COLON) {
+    const RuleTrace trace(*this, CFGNode::NodeKind::VAR_DECL_LIST);
+
+    skipUntil(FirstSets::get(CFGNode::NodeKind::VAR_DECL_LIST), ErrorLogger::ErrorType::MISSING_SEMI_COLON);
+    if (mCurrentToken != Lexer::Token::IDENTIFIER)
+        return std::make_unique<VarDeclList>();
+
+    ChildrenNode identifiers;
+    for (;;) {
+        identifiers.push_back(parseToken(Lexer::Token::IDENTIFIER));
+
+        skipUntil({Lexer::Token::COMMA, Lexer::Token::SEMI_COLON}, ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER);
+        if (mCurrentToken != Lexer::Token::COMMA)
+            break;
+        identifiers.push_back(parseToken(Lexer::Token::COMMA));
+
+        skipUntil(FirstSets::get(CFGNode::NodeKind::VAR_DECL_LIST), ErrorLogger::ErrorType::MISSING_SEMI_COLON);
+        if (mCurrentToken != Lexer::Token::IDENTIFIER) {
+            // The source ended after a comma
+            identifiers.push_back(std::make_unique<VarDeclList>());
+            break;
+        }
     }
 
-    return varDeclList_Node;
+    return std::make_unique<VarDeclList>(std::move(identifiers));
 }
 
 std::unique_ptr<FnDecl> Parser::parseFnDecl() {
-    auto fnDeclNode = std::make_unique<FnDecl>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::FN_DECL);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and fnDeclNode->first.find(mCurrentToken) == fnDeclNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::FN_DECL).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::KW_FN) {
@@ -161,48 +225,44 @@ std::unique_ptr<FnDecl> Parser::parseFnDecl() {
         std::unique_ptr<Type> type = parseType();
         std::unique_ptr<Segment> segment = parseSegment();
 
-        fnDeclNode.reset(new FnDecl(
+        return std::make_unique<FnDecl>(
             std::move(kw_fn),
             std::move(id),
             std::move(lparen),
             std::move(argList),
             std::move(rparen),
             std::move(type),
-            std::move(segment)));
+            std::move(segment));
     }
 
-    return fnDeclNode;
+    return std::make_unique<FnDecl>();
 }
 
 std::unique_ptr<FnParamList> Parser::parseFnParamList() {
-    auto fnParamListNode = std::make_unique<FnParamList>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::FN_PARAM_LIST);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and fnParamListNode->first.find(mCurrentToken) == fnParamListNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
-    }
+    ChildrenNode params;
+    skipUntil(FirstSets::get(CFGNode::NodeKind::FN_PARAM_LIST), ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER);
+    while (FirstSets::get(CFGNode::NodeKind::FN_PARAM).contains(mCurrentToken)) {
+        params.push_back(parseFnParam());
 
-    if (mCurrentToken == Lexer::Token::LBRACKET or
-        (mCurrentToken >= Lexer::Token::KW_INT_32 and mCurrentToken <= Lexer::Token::KW_VOID)) {
-        std::unique_ptr<FnParam> fnParam = parseFnParam();
-        std::unique_ptr<FnParamList_> fnParamList_ = parseFnParamList_();
+        skipUntil({Lexer::Token::COMMA, Lexer::Token::RPAREN}, ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER);
+        if (mCurrentToken != Lexer::Token::COMMA)
+            break;
+        params.push_back(parseToken(Lexer::Token::COMMA));
 
-        fnParamListNode.reset(new FnParamList(
-            std::move(fnParam),
-            std::move(fnParamList_)));
-    } else if (mCurrentToken == Lexer::Token::RPAREN) {
-        // epslion do nothing
+        skipUntil(FirstSets::get(CFGNode::NodeKind::FN_PARAM_LIST), ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER);
     }
 
-    return fnParamListNode;
+    return std::make_unique<FnParamList>(std::move(params));
 }
 
 std::unique_ptr<FnParam> Parser::parseFnParam() {
-    auto fnParamNode = std::make_unique<FnParam>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::FN_PARAM);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and fnParamNode->first.find(mCurrentToken) == fnParamNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::FN_PARAM).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::LBRACKET or
@@ -210,96 +270,50 @@ std::unique_ptr<FnParam> Parser::parseFnParam() {
         std::unique_ptr<Type> type = parseType();
         std::unique_ptr<Token> identifier = parseToken(Lexer::Token::IDENTIFIER);
 
-        fnParamNode.reset(new FnParam(
+        return std::make_unique<FnParam>(
             std::move(type),
-            std::move(identifier)));
+            std::move(identifier));
     }
 
-    return fnParamNode;
-}
-
-std::unique_ptr<FnParamList_> Parser::parseFnParamList_() {
-    auto fnParamList_Node = std::make_unique<FnParamList_>();
-
-    while (mCurrentToken != Lexer::Token::TOK_EOF and fnParamList_Node->first.find(mCurrentToken) == fnParamList_Node->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
-    }
-
-    if (mCurrentToken == Lexer::Token::COMMA) {
-        std::unique_ptr<Token> comma = parseToken(Lexer::Token::COMMA);
-        std::unique_ptr<FnParamList> fnParamList = parseFnParamList();
-
-        fnParamList_Node.reset(new FnParamList_(
-            std::move(comma),
-            std::move(fnParamList)));
-    } else if (mCurrentToken == Lexer::Token::RPAREN) {
-        // epslion do nothing
-    }
-
-    return fnParamList_Node;
+    return std::make_unique<FnParam>();
 }
 
 std::unique_ptr<Expression> Parser::parseExpression() {
-    auto expressionNode = std::make_unique<Expression>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::EXPRESSION);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and expressionNode->first.find(mCurrentToken) == expressionNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::EXPRESSION).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::LPAREN or mCurrentToken == Lexer::Token::OP_MINUS or
         mCurrentToken == Lexer::Token::KW_TRUE or mCurrentToken == Lexer::Token::KW_FALSE or
         (mCurrentToken >= Lexer::Token::INT_LITERAL and mCurrentToken <= Lexer::Token::STR_LITERAL) or
         mCurrentToken == Lexer::Token::IDENTIFIER) {
-        std::unique_ptr<Term> term = parseTerm();
-        std::unique_ptr<ExpressionRHS> expressionRHS = parseExpressionRHS();
-
-        expressionNode.reset(
-            new Expression(
-                std::move(term),
-                std::move(expressionRHS)));
-    }
-
-    return expressionNode;
-}
-
-std::unique_ptr<ExpressionRHS> Parser::parseExpressionRHS() {
-    auto expressionRHSNode = std::make_unique<ExpressionRHS>();
-
-    while (mCurrentToken != Lexer::Token::TOK_EOF and expressionRHSNode->first.find(mCurrentToken) == expressionRHSNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
-    }
-
-    if (mCurrentToken >= Lexer::Token::OP_PLUS and mCurrentToken <= Lexer::Token::OP_LT) {
-        std::unique_ptr<Token> bin_op = parseToken(mCurrentToken);
-        std::unique_ptr<Expression> expression = parseExpression();
-
-        expressionRHSNode.reset(new ExpressionRHS(
-            std::move(bin_op),
-            std::move(expression)));
-    }
+        // Pratt parsing, the operators wait for their right operand in builder rather than on the call stack
+        ExpressionBuilder builder;
+        builder.pushOperand(parseTerm());
+        for (;;) {
+            skipUntil(FirstSets::get(CFGNode::NodeKind::BINARY_EXPRESSION), ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER);
+            const Lexer::Token op = mCurrentToken;
+            if (ExpressionBuilder::bindingPower(op) == 0)
+                break;
+            builder.pushOperator(op, parseToken(op));
+            builder.pushOperand(parseTerm());
+        }
 
-    else if (
-        mCurrentToken == Lexer::Token::RPAREN or
-        mCurrentToken == Lexer::Token::RBRACKET or
-        mCurrentToken == Lexer::Token::COMMA or
-        mCurrentToken == Lexer::Token::SEMI_COLON or
-        mCurrentToken == Lexer::Token::LBRACE or
-        mCurrentToken == Lexer::Token::RANGE) {
-        // epsilon do nothing
+        return std::make_unique<Expression>(builder.finish());
     }
 
-    return expressionRHSNode;
+    return std::make_unique<Expression>();
 }
 
 std::unique_ptr<Term> Parser::parseTerm() {
-    auto termNode = std::make_unique<Term>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::TERM);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and termNode->first.find(mCurrentToken) == termNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::TERM).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::LPAREN) {
@@ -307,72 +321,71 @@ std::unique_ptr<Term> Parser::parseTerm() {
         std::unique_ptr<Expression> expression = parseExpression();
         std::unique_ptr<Token> rparen = parseToken(Lexer::Token::RPAREN);
 
-        termNode.reset(new Term(
+        return std::make_unique<Term>(
             std::move(lparen),
             std::move(expression),
-            std::move(rparen)));
+            std::move(rparen));
 
     } else if (mCurrentToken == Lexer::Token::OP_MINUS) {
         std::unique_ptr<Token> op_minus = parseToken(Lexer::Token::OP_MINUS);
         std::unique_ptr<FloatTerm> floatTerm = parseFloatTerm();
-        std::unique_ptr<Token> rparen = parseToken(Lexer::Token::RPAREN);
 
-        termNode.reset(new Term(
+        return std::make_unique<Term>(
             std::move(op_minus),
-            std::move(floatTerm)));
+            std::move(floatTerm));
 
     } else if (mCurrentToken == Lexer::Token::INT_LITERAL or mCurrentToken == Lexer::Token::FLOAT_LITERAL) {
         std::unique_ptr<FloatTerm> floatTerm = parseFloatTerm();
-        termNode.reset(new Term(std::move(floatTerm)));
+        return std::make_unique<Term>(std::move(floatTerm));
 
     } else if (mCurrentToken == Lexer::Token::KW_TRUE or mCurrentToken == Lexer::Token::KW_FALSE or mCurrentToken == Lexer::Token::STR_LITERAL) {
         std::unique_ptr<Token> literal = parseToken(mCurrentToken);
-        termNode.reset(new Term(std::move(literal)));
+        return std::make_unique<Term>(std::move(literal));
 
     } else if (mCurrentToken == Lexer::Token::IDENTIFIER) {
-        auto nextToken = peekNextToken();
+        auto nextToken = peek(1);
         if (nextToken == Lexer::Token::LBRACKET) {
             std::unique_ptr<ArraySubscript> arraySubscript = parseArraySubscript();
-            termNode.reset(new Term(std::move(arraySubscript)));
+            return std::make_unique<Term>(std::move(arraySubscript));
 
         } else if (nextToken == Lexer::Token::LPAREN) {
             std::unique_ptr<Call> call = parseCall();
-            termNode.reset(new Term(std::move(call)));
+            return std::make_unique<Term>(std::move(call));
         } else {
             std::unique_ptr<Token> identifier = parseToken(Lexer::Token::IDENTIFIER);
 
-            termNode.reset(new Term(std::move(identifier)));
+            return std::make_unique<Term>(std::move(identifier));
         }
     }
 
-    return termNode;
+    return std::make_unique<Term>();
 }
 
 std::unique_ptr<FloatTerm> Parser::parseFloatTerm() {
-    auto floatTermNode = std::make_unique<FloatTerm>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::FLOAT_TERM);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and floatTermNode->first.find(mCurrentToken) == floatTermNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::FLOAT_TERM).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::INT_LITERAL) {
         std::unique_ptr<Token> int_literal = parseToken(Lexer::Token::INT_LITERAL);
-        floatTermNode.reset(new FloatTerm(std::move(int_literal)));
+        return std::make_unique<FloatTerm>(std::move(int_literal));
     } else if (mCurrentToken == Lexer::Token::FLOAT_LITERAL) {
         std::unique_ptr<Token> float_literal = parseToken(Lexer::Token::FLOAT_LITERAL);
-        floatTermNode.reset(new FloatTerm(std::move(float_literal)));
+        return std::make_unique<FloatTerm>(std::move(float_literal));
     }
 
-    return floatTermNode;
+    return std::make_unique<FloatTerm>();
 }
 
 std::unique_ptr<ArraySubscript> Parser::parseArraySubscript() {
-    auto arraySubscriptNode = std::make_unique<ArraySubscript>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::ARRAY_SUBSCRIPT);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and arraySubscriptNode->first.find(mCurrentToken) == arraySubscriptNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::ARRAY_SUBSCRIPT).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::IDENTIFIER) {
@@ -381,22 +394,22 @@ std::unique_ptr<ArraySubscript> Parser::parseArraySubscript() {
         std::unique_ptr<Expression> expression = parseExpression();
         std::unique_ptr<Token> rbracket = parseToken(Lexer::Token::RBRACKET);
 
-        arraySubscriptNode.reset(new ArraySubscript(
+        return std::make_unique<ArraySubscript>(
             std::move(identifier),
             std::move(lbracket),
             std::move(expression),
-            std::move(rbracket)));
+            std::move(rbracket));
     }
 
-    return arraySubscriptNode;
+    return std::make_unique<ArraySubscript>();
 }
 
 std::unique_ptr<Call> Parser::parseCall() {
-    auto callNode = std::make_unique<Call>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::CALL);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and callNode->first.find(mCurrentToken) == callNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::CALL).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::IDENTIFIER) {
@@ -405,126 +418,75 @@ std::unique_ptr<Call> Parser::parseCall() {
         std::unique_ptr<CallParamList> callParamList = parseCallParamList();
         std::unique_ptr<Token> rparen = parseToken(Lexer::Token::RPAREN);
 
-        callNode.reset(new Call(
+        return std::make_unique<Call>(
             std::move(identifier),
             std::move(lparen),
             std::move(callParamList),
-            std::move(rparen)));
+            std::move(rparen));
     }
 
-    return callNode;
+    return std::make_unique<Call>();
 }
 
 std::unique_ptr<CallParamList> Parser::parseCallParamList() {
-    auto callParamListNode = std::make_unique<CallParamList>();
-
-    while (mCurrentToken != Lexer::Token::TOK_EOF and callParamListNode->first.find(mCurrentToken) == callParamListNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
-    }
-
-    if (mCurrentToken == Lexer::Token::LPAREN or mCurrentToken == Lexer::Token::OP_MINUS or
-        (mCurrentToken >= Lexer::Token::INT_LITERAL and mCurrentToken <= Lexer::Token::STR_LITERAL) or
-        mCurrentToken == Lexer::Token::KW_TRUE or mCurrentToken == Lexer::Token::KW_FALSE or
-        mCurrentToken == Lexer::Token::IDENTIFIER) {
-        std::unique_ptr<Expression> expression = parseExpression();
-        std::unique_ptr<CallParamList_> callParamList_ = parseCallParamList_();
-
-        callParamListNode.reset(new CallParamList(
-            std::move(expression),
-            std::move(callParamList_)));
-    } else if (mCurrentToken == Lexer::Token::RPAREN) {
-        // epsilon do nothing
-    }
+    const RuleTrace trace(*this, CFGNode::NodeKind::CALL_PARAM_LIST);
 
-    return callParamListNode;
-}
+    ChildrenNode params;
+    skipUntil(FirstSets::get(CFGNode::NodeKind::CALL_PARAM_LIST), ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER);
+    while (FirstSets::get(CFGNode::NodeKind::EXPRESSION).contains(mCurrentToken)) {
+        params.push_back(parseExpression());
 
-std::unique_ptr<CallParamList_> Parser::parseCallParamList_() {
-    auto callParamList_Node = std::make_unique<CallParamList_>();
+        skipUntil({Lexer::Token::COMMA, Lexer::Token::RPAREN}, ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER);
+        if (mCurrentToken != Lexer::Token::COMMA)
+            break;
+        params.push_back(parseToken(Lexer::Token::COMMA));
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and callParamList_Node->first.find(mCurrentToken) == callParamList_Node->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+        skipUntil(FirstSets::get(CFGNode::NodeKind::CALL_PARAM_LIST), ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER);
     }
 
-    if (mCurrentToken == Lexer::Token::COMMA) {
-        std::unique_ptr<Token> comma = parseToken(Lexer::Token::COMMA);
-        std::unique_ptr<CallParamList> callParamList = parseCallParamList();
-
-        callParamList_Node.reset(new CallParamList_(
-            std::move(comma),
-            std::move(callParamList)));
-    } else if (mCurrentToken == Lexer::Token::RPAREN) {
-        // epsilon do nothing
-    }
-
-    return callParamList_Node;
+    return std::make_unique<CallParamList>(std::move(params));
 }
 
 std::unique_ptr<StmtList> Parser::parseStmtList() {
-    auto stmtListNode = std::make_unique<StmtList>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::STMT_LIST);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and stmtListNode->first.find(mCurrentToken) == stmtListNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    ChildrenNode stmts;
+    for (;;) {
+        skipUntil(FirstSets::get(CFGNode::NodeKind::STMT_LIST), ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER);
+        // RBRACE or TOK_EOF end the list
+        if (!FirstSets::get(CFGNode::NodeKind::STMT).contains(mCurrentToken))
+            break;
+        stmts.push_back(parseStmt());
     }
 
-    if (mCurrentToken == Lexer::Token::LBRACE or
-        (mCurrentToken >= Lexer::Token::KW_INT_32 and mCurrentToken <= Lexer::Token::KW_VOID) or
-        mCurrentToken == Lexer::Token::LBRACKET or
-        mCurrentToken == Lexer::Token::KW_RETURN or
-        mCurrentToken == Lexer::Token::IDENTIFIER or
-        mCurrentToken == Lexer::Token::LPAREN or
-        mCurrentToken == Lexer::Token::OP_MINUS or
-        mCurrentToken == Lexer::Token::INT_LITERAL or
-        mCurrentToken == Lexer::Token::FLOAT_LITERAL or
-        mCurrentToken == Lexer::Token::STR_LITERAL or
-        mCurrentToken == Lexer::Token::KW_TRUE or
-        mCurrentToken == Lexer::Token::KW_FALSE or
-        mCurrentToken == Lexer::Token::KW_IF or
-        mCurrentToken == Lexer::Token::KW_FOR or
-        mCurrentToken == Lexer::Token::KW_WHILE) {
-        std::unique_ptr<Stmt> stmt = parseStmt();
-        std::unique_ptr<StmtList> stmtList = parseStmtList();
-
-        stmtListNode.reset(new StmtList(
-            std::move(stmt),
-            std::move(stmtList)));
-    }
-
-    else if (mCurrentToken == Lexer::Token::RBRACE) {
-        // do nothing
-    }
-
-    return stmtListNode;
+    return std::make_unique<StmtList>(std::move(stmts));
 }
 
 std::unique_ptr<Stmt> Parser::parseStmt() {
-    auto stmtNode = std::make_unique<Stmt>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::STMT);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and stmtNode->first.find(mCurrentToken) == stmtNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::STMT).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::LBRACE) {
         std::unique_ptr<Segment> segment = parseSegment();
 
-        stmtNode.reset(new Stmt(std::move(segment)));
+        return std::make_unique<Stmt>(std::move(segment));
     }
 
     else if (mCurrentToken == Lexer::Token::KW_IF) {
         std::unique_ptr<ConditionalStmt> conditionalStmt = parseConditionalStmt();
 
-        stmtNode.reset(new Stmt(
-            std::move(conditionalStmt)));
+        return std::make_unique<Stmt>(
+            std::move(conditionalStmt));
     }
 
     else if (mCurrentToken == Lexer::Token::KW_FOR or mCurrentToken == Lexer::Token::KW_WHILE) {
         std::unique_ptr<LoopStmt> loopStmt = parseLoopStmt();
-        stmtNode.reset(new Stmt(
-            std::move(loopStmt)));
+        return std::make_unique<Stmt>(
+            std::move(loopStmt));
     }
 
     else if ((mCurrentToken >= Lexer::Token::KW_INT_32 and mCurrentToken <= Lexer::Token::KW_VOID) or
@@ -532,30 +494,30 @@ std::unique_ptr<Stmt> Parser::parseStmt() {
         std::unique_ptr<VarDecl> vardecl = parseVarDecl();
         std::unique_ptr<Token> semi_colon = parseToken(Lexer::Token::SEMI_COLON);
 
-        stmtNode.reset(new Stmt(
+        return std::make_unique<Stmt>(
             std::move(vardecl),
-            std::move(semi_colon)));
+            std::move(semi_colon));
     }
 
     else if (mCurrentToken == Lexer::Token::KW_RETURN) {
         std::unique_ptr<ReturnStmt> returnStmt = parseReturnStmt();
         std::unique_ptr<Token> semi_colon = parseToken(Lexer::Token::SEMI_COLON);
 
-        stmtNode.reset(new Stmt(
-            std::move(returnStmt), std::move(semi_colon)));
+        return std::make_unique<Stmt>(
+            std::move(returnStmt), std::move(semi_colon));
     }
 
     else if (mCurrentToken == Lexer::Token::IDENTIFIER) {
-        if (peekNextToken() == Lexer::Token::ASSIGN) {
+        if (peek(1) == Lexer::Token::ASSIGN) {
             std::unique_ptr<AssignmentStmt> assignment_stmt = parseAssignmentStmt();
             std::unique_ptr<Token> semi_colon = parseToken(Lexer::Token::SEMI_COLON);
 
-            stmtNode.reset(new Stmt(std::move(assignment_stmt), std::move(semi_colon)));
+            return std::make_unique<Stmt>(std::move(assignment_stmt), std::move(semi_colon));
         } else {
             std::unique_ptr<Expression> expression = parseExpression();
             std::unique_ptr<Token> semi_colon = parseToken(Lexer::Token::SEMI_COLON);
 
-            stmtNode.reset(new Stmt(std::move(expression), std::move(semi_colon)));
+            return std::make_unique<Stmt>(std::move(expression), std::move(semi_colon));
         }
     }
 
@@ -569,19 +531,19 @@ std::unique_ptr<Stmt> Parser::parseStmt() {
         std::unique_ptr<Expression> exp = parseExpression();
         std::unique_ptr<Token> semi_colon = parseToken(Lexer::Token::SEMI_COLON);
 
-        stmtNode.reset(new Stmt(
-            std::move(exp), std::move(semi_colon)));
+        return std::make_unique<Stmt>(
+            std::move(exp), std::move(semi_colon));
     }
 
-    return stmtNode;
+    return std::make_unique<Stmt>();
 }
 
 std::unique_ptr<AssignmentStmt> Parser::parseAssignmentStmt() {
-    auto assignmentStmtNode = std::make_unique<AssignmentStmt>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::ASSIGNMENT_STMT);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and assignmentStmtNode->first.find(mCurrentToken) == assignmentStmtNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::ASSIGNMENT_STMT).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::IDENTIFIER) {
@@ -589,21 +551,21 @@ std::unique_ptr<AssignmentStmt> Parser::parseAssignmentStmt() {
         std::unique_ptr<Token> assign = parseToken(Lexer::Token::ASSIGN);
         std::unique_ptr<Expression> expression = parseExpression();
 
-        assignmentStmtNode.reset(new AssignmentStmt(
+        return std::make_unique<AssignmentStmt>(
             std::move(id),
             std::move(assign),
-            std::move(expression)));
+            std::move(expression));
     }
 
-    return assignmentStmtNode;
+    return std::make_unique<AssignmentStmt>();
 }
 
 std::unique_ptr<ConditionalStmt> Parser::parseConditionalStmt() {
-    auto conditionalStmtNode = std::make_unique<ConditionalStmt>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::CONDITIONAL_STMT);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and conditionalStmtNode->first.find(mCurrentToken) == conditionalStmtNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::CONDITIONAL_STMT).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::KW_IF) {
@@ -611,62 +573,62 @@ std::unique_ptr<ConditionalStmt> Parser::parseConditionalStmt() {
         std::unique_ptr<ElifBlocks> elifBlocks = parseElifBlocks();
         std::unique_ptr<ElseBlock> elseBlock = parseElseBlock();
 
-        conditionalStmtNode.reset(new ConditionalStmt(
+        return std::make_unique<ConditionalStmt>(
             std::move(ifBlock),
             std::move(elifBlocks),
-            std::move(elseBlock)));
+            std::move(elseBlock));
     }
 
-    return conditionalStmtNode;
+    return std::make_unique<ConditionalStmt>();
 }
 
 std::unique_ptr<LoopStmt> Parser::parseLoopStmt() {
-    auto loopStmtNode = std::make_unique<LoopStmt>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::LOOP_STMT);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and loopStmtNode->first.find(mCurrentToken) == loopStmtNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::LOOP_STMT).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::KW_FOR) {
         std::unique_ptr<ForLoop> forLoop = parseForLoop();
-        loopStmtNode.reset(new LoopStmt(std::move(forLoop)));
+        return std::make_unique<LoopStmt>(std::move(forLoop));
     }
 
     else if (mCurrentToken == Lexer::Token::KW_WHILE) {
         std::unique_ptr<WhileLoop> whileLoop = parseWhileLoop();
-        loopStmtNode.reset(new LoopStmt(std::move(whileLoop)));
+        return std::make_unique<LoopStmt>(std::move(whileLoop));
     }
 
-    return loopStmtNode;
+    return std::make_unique<LoopStmt>();
 }
 
 std::unique_ptr<ReturnStmt> Parser::parseReturnStmt() {
-    auto returnStmtNode = std::make_unique<ReturnStmt>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::RETURN_STMT);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and returnStmtNode->first.find(mCurrentToken) == returnStmtNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::RETURN_STMT).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::KW_RETURN) {
         std::unique_ptr<Token> kw_return = parseToken(Lexer::Token::KW_RETURN);
         std::unique_ptr<ReturnVar> returnVar = parseReturnVar();
 
-        returnStmtNode.reset(new ReturnStmt(
+        return std::make_unique<ReturnStmt>(
             std::move(kw_return),
-            std::move(returnVar)));
+            std::move(returnVar));
     }
 
-    return returnStmtNode;
+    return std::make_unique<ReturnStmt>();
 }
 
 std::unique_ptr<IfBlock> Parser::parseIfBlock() {
-    auto ifBlockNode = std::make_unique<IfBlock>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::IF_BLOCK);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and ifBlockNode->first.find(mCurrentToken) == ifBlockNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::IF_BLOCK).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::KW_IF) {
@@ -674,43 +636,43 @@ std::unique_ptr<IfBlock> Parser::parseIfBlock() {
         std::unique_ptr<Expression> exp = parseExpression();
         std::unique_ptr<Segment> segment = parseSegment();
 
-        ifBlockNode.reset(new IfBlock(
+        return std::make_unique<IfBlock>(
             std::move(kw_if),
             std::move(exp),
-            std::move(segment)));
+            std::move(segment));
     }
 
-    return ifBlockNode;
+    return std::make_unique<IfBlock>();
 }
 
 std::unique_ptr<ElifBlocks> Parser::parseElifBlocks() {
-    auto elifBlocksNode = std::make_unique<ElifBlocks>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::ELIF_BLOCKS);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and elifBlocksNode->first.find(mCurrentToken) == elifBlocksNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::ELIF_BLOCKS).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::KW_ELIF) {
         std::unique_ptr<ElifBlock> elifBlock = parseElifBlock();
         std::unique_ptr<ElifBlocks> elifBlocks = parseElifBlocks();
 
-        elifBlocksNode.reset(new ElifBlocks(
+        return std::make_unique<ElifBlocks>(
             std::move(elifBlock),
-            std::move(elifBlocks)));
+            std::move(elifBlocks));
     } else {
         // epsilon do nothing
     }
 
-    return elifBlocksNode;
+    return std::make_unique<ElifBlocks>();
 }
 
 std::unique_ptr<ElifBlock> Parser::parseElifBlock() {
-    auto elifBlockNode = std::make_unique<ElifBlock>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::ELIF_BLOCK);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and elifBlockNode->first.find(mCurrentToken) == elifBlockNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::ELIF_BLOCK).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::KW_ELIF) {
@@ -718,43 +680,43 @@ std::unique_ptr<ElifBlock> Parser::parseElifBlock() {
         std::unique_ptr<Expression> exp = parseExpression();
         std::unique_ptr<Segment> segment = parseSegment();
 
-        elifBlockNode.reset(new ElifBlock(
+        return std::make_unique<ElifBlock>(
             std::move(kw_elif),
             std::move(exp),
-            std::move(segment)));
+            std::move(segment));
     }
 
-    return elifBlockNode;
+    return std::make_unique<ElifBlock>();
 }
 
 std::unique_ptr<ElseBlock> Parser::parseElseBlock() {
-    auto elseBlockNode = std::make_unique<ElseBlock>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::ELSE_BLOCK);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and elseBlockNode->first.find(mCurrentToken) == elseBlockNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::ELSE_BLOCK).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::KW_ELSE) {
         std::unique_ptr<Token> kw_else = parseToken(Lexer::Token::KW_ELSE);
         std::unique_ptr<Segment> segment = parseSegment();
 
-        elseBlockNode.reset(new ElseBlock(
+        return std::make_unique<ElseBlock>(
             std::move(kw_else),
-            std::move(segment)));
+            std::move(segment));
     } else {
         // epsilon do nothing
     }
 
-    return elseBlockNode;
+    return std::make_unique<ElseBlock>();
 }
 
 std::unique_ptr<ForLoop> Parser::parseForLoop() {
-    auto forLoopNode = std::make_unique<ForLoop>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::FOR_LOOP);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and forLoopNode->first.find(mCurrentToken) == forLoopNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::FOR_LOOP).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::KW_FOR) {
@@ -764,23 +726,23 @@ std::unique_ptr<ForLoop> Parser::parseForLoop() {
         std::unique_ptr<LoopRange> loopRange = parseLoopRange();
         std::unique_ptr<Segment> segment = parseSegment();
 
-        forLoopNode.reset(new ForLoop(
+        return std::make_unique<ForLoop>(
             std::move(kw_for),
             std::move(id),
             std::move(kw_in),
             std::move(loopRange),
-            std::move(segment)));
+            std::move(segment));
     }
 
-    return forLoopNode;
+    return std::make_unique<ForLoop>();
 }
 
 std::unique_ptr<LoopRange> Parser::parseLoopRange() {
-    auto loopRangeNode = std::make_unique<LoopRange>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::LOOP_RANGE);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and loopRangeNode->first.find(mCurrentToken) == loopRangeNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::LOOP_RANGE).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::LPAREN or
@@ -788,52 +750,53 @@ std::unique_ptr<LoopRange> Parser::parseLoopRange() {
         mCurrentToken == Lexer::Token::KW_TRUE or mCurrentToken == Lexer::Token::KW_FALSE or
         mCurrentToken == Lexer::Token::INT_LITERAL or
         mCurrentToken == Lexer::Token::FLOAT_LITERAL or
+        mCurrentToken == Lexer::Token::STR_LITERAL or
         mCurrentToken == Lexer::Token::IDENTIFIER) {
         std::unique_ptr<Expression> start_expression = parseExpression();
         std::unique_ptr<Token> range = parseToken(Lexer::Token::RANGE);
         std::unique_ptr<Expression> end_expression = parseExpression();
         std::unique_ptr<LoopStep> loopStep = parseLoopStep();
 
-        loopRangeNode.reset(new LoopRange(
+        return std::make_unique<LoopRange>(
             std::move(start_expression),
             std::move(range),
             std::move(end_expression),
-            std::move(loopStep)));
+            std::move(loopStep));
     }
 
-    return loopRangeNode;
+    return std::make_unique<LoopRange>();
 }
 
 std::unique_ptr<LoopStep> Parser::parseLoopStep() {
-    auto loopStepNode = std::make_unique<LoopStep>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::LOOP_STEP);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and loopStepNode->first.find(mCurrentToken) == loopStepNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::LOOP_STEP).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::RANGE) {
         std::unique_ptr<Token> range = parseToken(Lexer::Token::RANGE);
         std::unique_ptr<Expression> expression = parseExpression();
 
-        loopStepNode.reset(new LoopStep(
+        return std::make_unique<LoopStep>(
             std::move(range),
-            std::move(expression)));
+            std::move(expression));
     }
 
     else if (mCurrentToken == Lexer::Token::LBRACE) {
         // do nothing
     }
 
-    return loopStepNode;
+    return std::make_unique<LoopStep>();
 }
 
 std::unique_ptr<WhileLoop> Parser::parseWhileLoop() {
-    auto whileLoopNode = std::make_unique<WhileLoop>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::WHILE_LOOP);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and whileLoopNode->first.find(mCurrentToken) == whileLoopNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::WHILE_LOOP).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::KW_WHILE) {
@@ -841,21 +804,21 @@ std::unique_ptr<WhileLoop> Parser::parseWhileLoop() {
         std::unique_ptr<Expression> exp = parseExpression();
         std::unique_ptr<Segment> segment = parseSegment();
 
-        whileLoopNode.reset(new WhileLoop(
+        return std::make_unique<WhileLoop>(
             std::move(kw_while),
             std::move(exp),
-            std::move(segment)));
+            std::move(segment));
     }
 
-    return whileLoopNode;
+    return std::make_unique<WhileLoop>();
 }
 
 std::unique_ptr<ReturnVar> Parser::parseReturnVar() {
-    auto returnVarNode = std::make_unique<ReturnVar>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::RETURN_VAR);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and returnVarNode->first.find(mCurrentToken) == returnVarNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::RETURN_VAR).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::LPAREN or
@@ -868,23 +831,23 @@ std::unique_ptr<ReturnVar> Parser::parseReturnVar() {
         mCurrentToken == Lexer::Token::IDENTIFIER) {
         std::unique_ptr<Expression> exp = parseExpression();
 
-        returnVarNode.reset(new ReturnVar(
-            std::move(exp)));
+        return std::make_unique<ReturnVar>(
+            std::move(exp));
     }
 
     else if (mCurrentToken == Lexer::Token::SEMI_COLON) {
         // do nothing
     }
 
-    return returnVarNode;
+    return std::make_unique<ReturnVar>();
 }
 
 std::unique_ptr<Segment> Parser::parseSegment() {
-    auto segmentNode = std::make_unique<Segment>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::SEGMENT);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and segmentNode->first.find(mCurrentToken) == segmentNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::SEGMENT).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken == Lexer::Token::LBRACE) {
@@ -892,66 +855,67 @@ std::unique_ptr<Segment> Parser::parseSegment() {
         std::unique_ptr<StmtList> stmtList = parseStmtList();
         std::unique_ptr<Token> rbrace = parseToken(Lexer::Token::RBRACE);
 
-        segmentNode.reset(new Segment(
+        return std::make_unique<Segment>(
             std::move(lbrace),
             std::move(stmtList),
-            std::move(rbrace)));
+            std::move(rbrace));
     }
 
-    return segmentNode;
+    return std::make_unique<Segment>();
 }
 
-std::unique_ptr<Token> Parser::parseToken(Lexer::Token token) {
+std::unique_ptr<Token> Parser::parseToken(TokenSet expected) {
     std::unique_ptr<Crust::Token> parent;
+    const Lexer::Token token = mCurrentToken;
 
-    if (mCurrentToken != token) {
+    if (!expected.contains(token)) {
         std::cout << "Unknown Error\n";  // FIXME: Use ErrorLogger
     }
 
     else if (token == Lexer::Token::IDENTIFIER or token == Lexer::Token::STR_LITERAL) {
-        parent = std::make_unique<Token>(token, mLexer.getCurrentStr());
+        parent = std::make_unique<Token>(token, mTokens ? mTokens->getSymbol(mTokenIdx) : mCurrent.getSymbol());
     }
 
     else if (token == Lexer::Token::INT_LITERAL) {
-        parent = std::make_unique<Token>(token, mLexer.getCurrentInt());
+        parent = std::make_unique<Token>(token, mTokens ? mTokens->getInt(mTokenIdx) : mCurrent.getInt());
     }
 
     else if (token == Lexer::Token::FLOAT_LITERAL) {
-        parent = std::make_unique<Token>(token, mLexer.getCurrentFloat());
+        parent = std::make_unique<Token>(token, mTokens ? mTokens->getFloat(mTokenIdx) : mCurrent.getFloat());
     }
 
     else {
         parent = std::make_unique<Token>(token);
     }
 
-    mCurrentToken = mLexer.getNextToken();
+    mCurrentToken = nextToken();
     return parent;
 }
 
 std::unique_ptr<Type> Parser::parseType() {
-    auto typeNode = std::make_unique<Type>();
+    const RuleTrace trace(*this, CFGNode::NodeKind::TYPE);
 
-    while (mCurrentToken != Lexer::Token::TOK_EOF and typeNode->first.find(mCurrentToken) == typeNode->first.end()) {
-        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, mLexer.GetCurrentLocation());
-        mCurrentToken = mLexer.getNextToken();
+    while (mCurrentToken != Lexer::Token::TOK_EOF and !FirstSets::get(CFGNode::NodeKind::TYPE).contains(mCurrentToken)) {
+        ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::VAR_MISSING_IDENTIFIER, currentSource(), currentLocation());
+        mCurrentToken = nextToken();
     }
 
     if (mCurrentToken >= Lexer::Token::KW_INT_32 and mCurrentToken <= Lexer::Token::KW_VOID) {
         std::unique_ptr<Token> atomic_type = parseToken(mCurrentToken);
-        typeNode.reset(new Type(std::move(atomic_type)));
+        return std::make_unique<Type>(std::move(atomic_type));
     } else if (mCurrentToken == Lexer::Token::LBRACKET) {
         std::unique_ptr<Token> lbracket = parseToken(Lexer::Token::LBRACKET);
         std::unique_ptr<Token> int_literal = parseToken(Lexer::Token::INT_LITERAL);
         std::unique_ptr<Token> rbracket = parseToken(Lexer::Token::RBRACKET);
         std::unique_ptr<Type> type = parseType();
 
-        typeNode.reset(new Type(std::move(lbracket),
+        return std::make_unique<Type>(std::move(lbracket),
                                 std::move(int_literal),
                                 std::move(rbracket),
-                                std::move(type)));
+                                std::move(type));
     }
 
-    return typeNode;
+    return std::make_unique<Type>();
 }
 
 }  // namespace Crust
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include <parser/scan.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CRUST_SCAN_X86 1
+#endif
+
+using namespace Crust;
+
+namespace {
+
+inline bool isWhitespace(char c) {
+    return c == ' ' or (c >= '\t' and c <= '\r');
+}
+
+const char* skipWhitespaceScalar(const char* it, const char* end) {
+    while (it != end and isWhitespace(*it))
+        ++it;
+    return it;
+}
+
+const char* findNewlineScalar(const char* it, const char* end) {
+    while (it != end and *it != '\n')
+        ++it;
+    return it;
+}
+
+const char* findStringEndScalar(const char* it, const char* end) {
+    while (it != end and *it != '\"' and *it != '\n' and *it != '\0')
+        ++it;
+    return it;
+}
+
+const char* findNonAsciiScalar(const char* it, const char* end) {
+    while (it != end and (unsigned char)*it < 0x80)
+        ++it;
+    return it;
+}
+
+#ifdef CRUST_SCAN_X86
+
+// Whitespace is ' ' or a byte in ['\t', '\r']. Bytes >= 0x80 compare as negative and are never whitespace.
+__attribute__((target("sse2"))) inline __m128i whitespaceMask128(__m128i bytes) {
+    const __m128i inRange = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('\t' - 1)),
+                                          _mm_cmplt_epi8(bytes, _mm_set1_epi8('\r' + 1)));
+    return _mm_or_si128(inRange, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+}
+
+__attribute__((target("sse2"))) const char* skipWhitespaceSSE2(const char* it, const char* end) {
+    for (; end - it >= 16; it += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const unsigned other = ~_mm_movemask_epi8(whitespaceMask128(bytes)) & 0xFFFF;
+        if (other)
+            return it + __builtin_ctz(other);
+    }
+    return skipWhitespaceScalar(it, end);
+}
+
+__attribute__((target("sse2"))) const char* findNewlineSSE2(const char* it, const char* end) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; end - it >= 16; it += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const unsigned found = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline));
+        if (found)
+            return it + __builtin_ctz(found);
+    }
+    return findNewlineScalar(it, end);
+}
+
+__attribute__((target("sse2"))) const char* findStringEndSSE2(const char* it, const char* end) {
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i zero = _mm_setzero_si128();
+    for (; end - it >= 16; it += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const __m128i stops = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, newline)),
+                                           _mm_cmpeq_epi8(bytes, zero));
+        const unsigned found = _mm_movemask_epi8(stops);
+        if (found)
+            return it + __builtin_ctz(found);
+    }
+    return findStringEndScalar(it, end);
+}
+
+// The sign bit of every byte is its non-ASCII bit, so movemask alone finds them
+__attribute__((target("sse2"))) const char* findNonAsciiSSE2(const char* it, const char* end) {
+    for (; end - it >= 16; it += 16) {
+        const unsigned found = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(it)));
+        if (found)
+            return it + __builtin_ctz(found);
+    }
+    return findNonAsciiScalar(it, end);
+}
+
+__attribute__((target("avx2"))) inline __m256i whitespaceMask256(__m256i bytes) {
+    const __m256i inRange = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('\t' - 1)),
+                                             _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), bytes));
+    return _mm256_or_si256(inRange, _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')));
+}
+
+__attribute__((target("avx2"))) const char* skipWhitespaceAVX2(const char* it, const char* end) {
+    for (; end - it >= 32; it += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+        const unsigned other = ~static_cast<unsigned>(_mm256_movemask_epi8(whitespaceMask256(bytes)));
+        if (other)
+            return it + __builtin_ctz(other);
+    }
+    return skipWhitespaceSSE2(it, end);
+}
+
+__attribute__((target("avx2"))) const char* findNewlineAVX2(const char* it, const char* end) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (; end - it >= 32; it += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+        const unsigned found = _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline));
+        if (found)
+            return it + __builtin_ctz(found);
+    }
+    return findNewlineSSE2(it, end);
+}
+
+__attribute__((target("avx2"))) const char* findStringEndAVX2(const char* it, const char* end) {
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i zero = _mm256_setzero_si256();
+    for (; end - it >= 32; it += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+        const __m256i stops = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, quote), _mm256_cmpeq_epi8(bytes, newline)),
+                                              _mm256_cmpeq_epi8(bytes, zero));
+        const unsigned found = _mm256_movemask_epi8(stops);
+        if (found)
+            return it + __builtin_ctz(found);
+    }
+    return findStringEndSSE2(it, end);
+}
+
+__attribute__((target("avx2"))) const char* findNonAsciiAVX2(const char* it, const char* end) {
+    for (; end - it >= 32; it += 32) {
+        const unsigned found = _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(it)));
+        if (found)
+            return it + __builtin_ctz(found);
+    }
+    return findNonAsciiSSE2(it, end);
+}
+
+#endif
+
+// getIsa installs the kernels of the CPU, the call is then made again through them
+const char* skipWhitespaceFirstUse(const char* it, const char* end) {
+    Scan::getIsa();
+    return Scan::skipWhitespace(it, end);
+}
+
+const char* findNewlineFirstUse(const char* it, const char* end) {
+    Scan::getIsa();
+    return Scan::findNewline(it, end);
+}
+
+const char* findStringEndFirstUse(const char* it, const char* end) {
+    Scan::getIsa();
+    return Scan::findStringEnd(it, end);
+}
+
+const char* findNonAsciiFirstUse(const char* it, const char* end) {
+    Scan::getIsa();
+    return Scan::findNonAscii(it, end);
+}
+
+}  // namespace
+
+const Scan::Kernels Scan::mFirstUse = {Isa::SCALAR, skipWhitespaceFirstUse, findNewlineFirstUse, findStringEndFirstUse,
+                                       findNonAsciiFirstUse};
+
+constinit std::atomic<const Scan::Kernels*> Scan::mKernels{&Scan::mFirstUse};
+
+Scan::Isa Scan::getIsa() {
+    const Kernels* kernels = &mFirstUse;
+    // Only the first pick wins, a racing one or a setIsa in between leaves mKernels alone
+    if (mKernels.compare_exchange_strong(kernels, select(detect())))
+        kernels = mKernels.load();
+    return kernels->isa;
+}
+
+bool Scan::isSupported(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR:
+            return true;
+#ifdef CRUST_SCAN_X86
+        case Isa::SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+        case Isa::AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+bool Scan::setIsa(Isa isa) {
+    if (!isSupported(isa))
+        return false;
+
+    mKernels.store(select(isa));
+    return true;
+}
+
+Scan::Isa Scan::detect() {
+    if (isSupported(Isa::AVX2))
+        return Isa::AVX2;
+    if (isSupported(Isa::SSE2))
+        return Isa::SSE2;
+    return Isa::SCALAR;
+}
+
+const Scan::Kernels* Scan::select(Isa isa) {
+    static constexpr Kernels SCALAR = {Isa::SCALAR, skipWhitespaceScalar, findNewlineScalar, findStringEndScalar, findNonAsciiScalar};
+#ifdef CRUST_SCAN_X86
+    static constexpr Kernels SSE2 = {Isa::SSE2, skipWhitespaceSSE2, findNewlineSSE2, findStringEndSSE2, findNonAsciiSSE2};
+    static constexpr Kernels AVX2 = {Isa::AVX2, skipWhitespaceAVX2, findNewlineAVX2, findStringEndAVX2, findNonAsciiAVX2};
+#endif
+
+    switch (isa) {
+#ifdef CRUST_SCAN_X86
+        case Isa::AVX2:
+            return &AVX2;
+        case Isa::SSE2:
+            return &SSE2;
+#endif
+        default:
+            return &SCALAR;
+    }
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <bit>
+#include <common/errorlogger.hpp>
+#include <parser/tokenpipeline.hpp>
+
+using namespace Crust;
+
+TokenPipeline::TokenPipeline(std::shared_ptr<const SourceBuffer> source, std::size_t batchSize, std::size_t batches)
+    : mSource{std::move(source)}, mBatchSize{std::max<std::size_t>(batchSize, 1)}, mBatches(std::bit_ceil(std::max<std::size_t>(batches, 2))) {
+    for (Batch& batch : mBatches) batch.tokens.reserve(mBatchSize);
+    mEof.kind = Lexer::Token::TOK_EOF;
+
+    mLexer.init(mSource);
+    mLexer.mSpeculative = true;
+    mProducer = std::thread([this] { produce(); });
+}
+
+TokenPipeline::~TokenPipeline() {
+    mStop.store(true);
+    // Wakes the producer if it waits for room, it checks mStop before using the ring again
+    mTail.fetch_add(1, std::memory_order_release);
+    mTail.notify_one();
+    mProducer.join();
+}
+
+void TokenPipeline::produce() {
+    for (bool done = false; !done;) {
+        const std::size_t head = mHead.load(std::memory_order_relaxed);
+        for (std::size_t tail = mTail.load(std::memory_order_acquire); head - tail >= mBatches.size(); tail = mTail.load(std::memory_order_acquire)) {
+            if (mStop.load())
+                return;
+            mTail.wait(tail, std::memory_order_acquire);
+        }
+        if (mStop.load())
+            return;
+
+        Batch& batch = mBatches[head & (mBatches.size() - 1)];
+        batch.tokens.clear();
+        batch.errors.clear();
+        batch.exception = nullptr;
+        try {
+            while (batch.tokens.size() < mBatchSize) {
+                const Lexer::Token token = mLexer.getNextToken();
+                if (mLexer.mPendingError) {
+                    batch.errors.push_back({batch.tokens.size(), *mLexer.mPendingError, mLexer.mPendingErrorLocation});
+                    mLexer.mPendingError.reset();
+                }
+                batch.tokens.push_back(mLexer.takeToken(token));
+                if (token == Lexer::Token::TOK_EOF) {
+                    done = true;
+                    break;
+                }
+            }
+        } catch (...) {
+            // Escaping the thread would terminate, the batch carries it to the consumer instead
+            batch.exception = std::current_exception();
+            done = true;
+        }
+
+        mHead.store(head + 1, std::memory_order_release);
+        mHead.notify_one();
+    }
+}
+
+void TokenPipeline::acquireBatch() {
+    std::size_t tail = mTail.load(std::memory_order_relaxed);
+    if (mBatch) {
+        mTail.store(++tail, std::memory_order_release);
+        mTail.notify_one();
+    }
+
+    for (std::size_t head = mHead.load(std::memory_order_acquire); head == tail; head = mHead.load(std::memory_order_acquire))
+        mHead.wait(head, std::memory_order_acquire);
+
+    mBatch = &mBatches[tail & (mBatches.size() - 1)];
+    mNext = 0;
+    mNextError = 0;
+}
+
+LexedToken TokenPipeline::next() {
+    if (mExhausted)
+        return mEof;
+
+    while (!mBatch or mNext == mBatch->tokens.size()) {
+        if (mBatch and mBatch->exception) {
+            mExhausted = true;
+            std::rethrow_exception(mBatch->exception);
+        }
+        acquireBatch();
+    }
+
+    for (; mNextError < mBatch->errors.size() and mBatch->errors[mNextError].token == mNext; ++mNextError) {
+        const Lexer::SpeculativeError& error = mBatch->errors[mNextError];
+        ErrorLogger::printErrorAtLocation(error.type, mSource->getLineColumn(error.location));
+    }
+
+    const Lexer::SpeculativeToken& speculative = mBatch->tokens[mNext++];
+    LexedToken token{speculative.kind, speculative.offset, speculative.length, {}};
+    switch (speculative.kind) {
+        case Lexer::Token::INT_LITERAL:
+            token.payload = speculative.value;
+            break;
+        case Lexer::Token::FLOAT_LITERAL:
+            token.payload = std::bit_cast<double>(speculative.value);
+            break;
+        case Lexer::Token::IDENTIFIER:
+        case Lexer::Token::STR_LITERAL:
+            token.payload = Lexer::internToken(speculative, mSource->getContents());
+            break;
+        case Lexer::Token::TOK_EOF:
+            mExhausted = true;
+            mEof = token;
+            break;
+        default:
+            break;
+    }
+    return token;
+}
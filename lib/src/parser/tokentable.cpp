@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <parser/tokentable.hpp>
+
+using namespace Crust;
+
+void TokenTable::reserve(std::size_t count) {
+    mKinds.reserve(count);
+    mOffsets.reserve(count);
+    mLengths.reserve(count);
+    mPayloads.reserve(count);
+}
+
+void TokenTable::push(Lexer::Token kind, std::uint64_t offset, std::uint64_t length) {
+    mKinds.push_back(static_cast<std::uint8_t>(kind));
+    mOffsets.push_back(offset - mShift);
+    mLengths.push_back(length);
+    mPayloads.push_back(NO_PAYLOAD);
+}
+
+void TokenTable::pushInt(Lexer::Token kind, std::uint64_t offset, std::uint64_t length, std::uint64_t value) {
+    push(kind, offset, length);
+    mPayloads.back() = mInts.size();
+    mInts.push_back(value);
+}
+
+void TokenTable::pushFloat(Lexer::Token kind, std::uint64_t offset, std::uint64_t length, double value) {
+    push(kind, offset, length);
+    mPayloads.back() = mFloats.size();
+    mFloats.push_back(value);
+}
+
+void TokenTable::pushSymbol(Lexer::Token kind, std::uint64_t offset, std::uint64_t length, Symbol value) {
+    push(kind, offset, length);
+    mPayloads.back() = value.getId();
+}
+
+template <typename T>
+void TokenTable::replaceRange(std::vector<T>& values, std::size_t first, std::size_t last, const std::vector<T>& replacement) {
+    const std::size_t common = std::min(last - first, replacement.size());
+    std::copy_n(replacement.begin(), common, values.begin() + first);
+    if (common < replacement.size())
+        values.insert(values.begin() + last, replacement.begin() + common, replacement.end());
+    else
+        values.erase(values.begin() + first + common, values.begin() + last);
+}
+
+template <typename T>
+std::uint32_t TokenTable::store(std::vector<T>& values, std::vector<std::uint32_t>& freeSlots, T value) {
+    if (freeSlots.empty()) {
+        values.push_back(value);
+        return values.size() - 1;
+    }
+    const std::uint32_t slot = freeSlots.back();
+    freeSlots.pop_back();
+    values[slot] = value;
+    return slot;
+}
+
+void TokenTable::splice(std::size_t first, std::size_t last, const TokenTable& replacement, std::int64_t delta,
+                        std::shared_ptr<const SourceBuffer> source) {
+    const auto INT = static_cast<std::uint8_t>(Lexer::Token::INT_LITERAL);
+    const auto FLOAT = static_cast<std::uint8_t>(Lexer::Token::FLOAT_LITERAL);
+
+    // The tokens after the replaced ones take the pending shift over, plus delta. Only those between
+    // the previous edit and this one change sides. Unsigned arithmetic wraps, so adding a shift also
+    // moves values down
+    if (mShift != 0) {
+        for (std::size_t idx = mShiftFrom; idx < first; ++idx) mOffsets[idx] += mShift;
+        for (std::size_t idx = last; idx < mShiftFrom; ++idx) mOffsets[idx] -= mShift;
+    }
+    mShift += static_cast<std::uint64_t>(delta);
+    mShiftFrom = first + replacement.size();
+
+    // The numbers of the replacement go to the slots the replaced tokens leave free
+    for (std::size_t idx = first; idx < last; ++idx) {
+        if (mKinds[idx] == INT)
+            mFreeInts.push_back(mPayloads[idx]);
+        else if (mKinds[idx] == FLOAT)
+            mFreeFloats.push_back(mPayloads[idx]);
+    }
+
+    std::vector<std::uint32_t> payloads = replacement.mPayloads;
+    for (std::size_t idx = 0; idx < payloads.size(); ++idx) {
+        if (replacement.mKinds[idx] == INT)
+            payloads[idx] = store(mInts, mFreeInts, replacement.mInts[payloads[idx]]);
+        else if (replacement.mKinds[idx] == FLOAT)
+            payloads[idx] = store(mFloats, mFreeFloats, replacement.mFloats[payloads[idx]]);
+    }
+
+    replaceRange(mKinds, first, last, replacement.mKinds);
+    replaceRange(mOffsets, first, last, replacement.mOffsets);
+    replaceRange(mLengths, first, last, replacement.mLengths);
+    replaceRange(mPayloads, first, last, payloads);
+
+    mSource = std::move(source);
+}
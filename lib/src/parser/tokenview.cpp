@@ -0,0 +1,12 @@
+#include <parser/tokenview.hpp>
+
+using namespace Crust;
+
+Generator<LexedToken> Crust::generateTokens(Lexer& lexer, bool keepComments) {
+    for (;;) {
+        const Lexer::Token kind = keepComments ? lexer.getNextTokenAndComment() : lexer.getNextToken();
+        if (kind == Lexer::Token::TOK_EOF)
+            co_return;
+        co_yield LexedToken::fromLexer(lexer, kind);
+    }
+}
@@ -0,0 +1,74 @@
+#include <bit>
+#include <iterator>
+#include <parser/trace.hpp>
+#include <string_view>
+
+using namespace Crust;
+
+namespace {
+
+// Spellings of CFGNode::NodeKind, in order
+constexpr std::string_view ruleNames[] = {
+    "PROG_DECL",
+    "DECL_LIST", "DECL",
+    "VAR_DECL", "VAR_DECL_LIST",
+    "FN_DECL", "FN_PARAM_LIST", "FN_PARAM",
+    "EXPRESSION", "BINARY_EXPRESSION",
+    "TERM", "FLOAT_TERM", "ARRAY_SUBSCRIPT", "CALL", "CALL_PARAM_LIST", "CALL_PARAM",
+    "STMT_LIST", "STMT", "ASSIGNMENT_STMT", "CONDITIONAL_STMT", "LOOP_STMT", "RETURN_STMT",
+    "IF_BLOCK", "ELIF_BLOCKS", "ELIF_BLOCK", "ELSE_BLOCK",
+    "FOR_LOOP", "LOOP_RANGE", "LOOP_STEP",
+    "WHILE_LOOP",
+    "RETURN_VAR",
+    "SEGMENT", "TYPE", "TOKEN", "ERROR"};
+
+// ERROR is the last NodeKind
+static_assert(std::size(ruleNames) == (std::size_t)CFGNode::NodeKind::ERROR + 1, "one spelling per NodeKind");
+
+}  // namespace
+
+Trace& Trace::local() {
+    static thread_local Trace trace;
+    return trace;
+}
+
+Trace::Trace(std::size_t capacity) : mRecords(std::bit_ceil(capacity ? capacity : 1)) {}
+
+void Trace::clear() {
+    mCount = 0;
+    mDepth = 0;
+}
+
+std::vector<Trace::Record> Trace::getRecords() const {
+    std::vector<Record> records;
+    records.reserve(size());
+    for (std::uint64_t idx = mCount - size(); idx < mCount; ++idx)
+        records.push_back(mRecords[idx & (mRecords.size() - 1)]);
+    return records;
+}
+
+void Trace::dump(std::ostream& stream) const {
+    const std::vector<Record> records = getRecords();
+    stream.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+}
+
+void Trace::print(std::ostream& stream) const {
+    if (getDropped() > 0)
+        stream << "... " << getDropped() << " earlier records dropped\n";
+
+    for (const Record& record : getRecords()) {
+        for (unsigned level = 0; level < record.depth; ++level) stream << "  ";
+
+        switch (record.event) {
+            case Event::TOKEN:
+                stream << Lexer::token_to_str[record.id] << " @" << record.offset << "+" << record.length << "\n";
+                break;
+            case Event::ENTER_RULE:
+                stream << "> " << ruleNames[record.id] << " @" << record.offset << "\n";
+                break;
+            case Event::EXIT_RULE:
+                stream << "< " << ruleNames[record.id] << " @" << record.offset << "\n";
+                break;
+        }
+    }
+}
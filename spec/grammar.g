@@ -0,0 +1,104 @@
+# Grammar of the crust language
+#
+# tools/parsegen compiles this file into the LL(1) tables of Parser::Backend::TABLE, see
+# lib/src/parser/llparser.cpp. The recursive descent functions of lib/src/parser/parser.cpp follow
+# the same rules and both build the same tree.
+#
+# `name: alternative | alternative` defines a rule, lines starting with whitespace continue the rule
+# above and `%empty` is the empty alternative. The first rule is the start rule.
+#   - A rule named after a CFGNode::NodeKind, in lowercase, builds one node of that kind holding a
+#     child per symbol of the alternative taken.
+#   - A rule whose name starts with `_` builds no node: its children go to the node of the rule
+#     using it. Lists are written as such rules, right recursive, so they do not nest.
+#   - UPPERCASE names are a Lexer::Token or a token class `NAME = TOKEN TOKEN ...`, which matches any
+#     of its tokens.
+#
+# Before expanding a rule the parser reports an error at every token that can neither start it nor,
+# if it may be empty, follow it, and skips that token. `name [ERROR]:` picks the ErrorLogger::ErrorType
+# reported, VAR_MISSING_IDENTIFIER when none is given. A rule with no alternative for the token left
+# builds an ERROR node, or an empty node of its own kind if it may be empty.
+#
+# Two alternatives starting with IDENTIFIER are told apart by the token after it, the one written
+# last among them takes the tokens none of them expects.
+
+# Token classes
+
+ATOMIC_TYPE = KW_INT_32 KW_INT_64 KW_UINT_32 KW_UINT_64 KW_FLOAT_32 KW_FLOAT_64 KW_STRING KW_BOOL KW_VOID
+BIN_OP = OP_PLUS OP_MINUS OP_MULT OP_DIV OP_MOD OP_AND OP_OR OP_GT OP_GE OP_EQ OP_NE OP_LE OP_LT
+BOOL_LITERAL = KW_TRUE KW_FALSE
+
+# Declarations
+
+prog_decl [EXPECTED_DECL]: decl_list
+
+decl_list [EXPECTED_DECL]: decl _decls | %empty
+_decls [EXPECTED_DECL]: decl _decls | %empty
+decl [EXPECTED_DECL]: fn_decl | var_decl SEMI_COLON
+
+var_decl [EXPECTED_DECL]: type var_decl_list
+var_decl_list [MISSING_SEMI_COLON]: IDENTIFIER _var_decl_tail
+_var_decl_tail: COMMA _var_decl_next | %empty
+# A comma ending the source leaves an ERROR in the list
+_var_decl_next [MISSING_SEMI_COLON]: IDENTIFIER _var_decl_tail
+
+fn_decl: KW_FN IDENTIFIER LPAREN fn_param_list RPAREN type segment
+fn_param_list: fn_param _fn_param_tail | %empty
+_fn_param_tail: COMMA _fn_param_next | %empty
+_fn_param_next: fn_param _fn_param_tail | %empty
+fn_param: type IDENTIFIER
+
+# Expressions
+
+# The terms and operators of an expression are parsed in a row, then folded by precedence into
+# BINARY_EXPRESSION nodes, see parser/expressionbuilder.hpp
+expression: term _operators
+_operators: BIN_OP term _operators | %empty
+
+term: LPAREN expression RPAREN
+    | OP_MINUS float_term
+    | float_term
+    | BOOL_LITERAL
+    | STR_LITERAL
+    | array_subscript
+    | call
+    | IDENTIFIER
+float_term: INT_LITERAL | FLOAT_LITERAL
+array_subscript: IDENTIFIER LBRACKET expression RBRACKET
+call: IDENTIFIER LPAREN call_param_list RPAREN
+call_param_list: expression _call_param_tail | %empty
+_call_param_tail: COMMA _call_param_next | %empty
+_call_param_next: expression _call_param_tail | %empty
+
+# Statements
+
+stmt_list: stmt _stmts | %empty
+_stmts: stmt _stmts | %empty
+stmt: segment
+    | conditional_stmt
+    | loop_stmt
+    | var_decl SEMI_COLON
+    | return_stmt SEMI_COLON
+    | assignment_stmt SEMI_COLON
+    | expression SEMI_COLON
+assignment_stmt: IDENTIFIER ASSIGN expression
+conditional_stmt: if_block elif_blocks else_block
+loop_stmt: for_loop | while_loop
+return_stmt: KW_RETURN return_var
+
+if_block: KW_IF expression segment
+elif_blocks: elif_block elif_blocks | %empty
+elif_block: KW_ELIF expression segment
+else_block: KW_ELSE segment | %empty
+
+for_loop: KW_FOR IDENTIFIER KW_IN loop_range segment
+loop_range: expression RANGE expression loop_step
+loop_step: RANGE expression | %empty
+
+while_loop: KW_WHILE expression segment
+
+return_var: expression | %empty
+
+# Misc
+
+segment: LBRACE stmt_list RBRACE
+type: ATOMIC_TYPE | LBRACKET INT_LITERAL RBRACKET type
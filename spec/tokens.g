@@ -1,3 +1,15 @@
+# Tokens of the crust language
+#
+# Every rule is `NAME: pattern`, where NAME is a Lexer::Token. Patterns made only of lowercase
+# letters are reserved words: the lexer matches them as an IDENTIFIER and Keywords picks the token.
+# Every other pattern is compiled into the lexer DFA by tools/lexgen and uses
+#   x       the byte x              \x      \n, \t, \r, \0, \xHH or a literal metacharacter
+#   [a-z]   a byte class            [^a-z]  a negated byte class
+#   .       any byte but \n         (a|b)   grouping and alternation
+#   a* a+ a?  repetition
+# The longest match wins and ties go to the rule written first. Whitespace between tokens is
+# skipped before matching.
+
 # Keywords
 
 ## Datatypes
@@ -15,7 +27,6 @@ KW_FALSE: false
 
 ## Declarations
 KW_LET: let
-KW_CONST: const
 
 # Conditions
 KW_IF: if
@@ -26,36 +37,32 @@ KW_ELSE: else
 KW_FOR: for
 KW_IN: in
 KW_WHILE: while
-KW_BREAK: break
-KW_CONTINUE: continue
 
 # Functions
 KW_FN: fn
 KW_RETURN: return
 
 
-# Modules
-KW_IMPORT: import
-KW_EXPORT: export
-
-
 # Literals
 INT_LITERAL: [0-9]+
-FLOAT_LITERAL: [0-9]+.[0-9]*
-STR_LITERAL: ".*"
+# The byte right after the dot always belongs to the literal
+FLOAT_LITERAL: [0-9]+\.([\x00-\xff][0-9]*)?
+# A NUL byte also closes a string
+STR_LITERAL: "[^"\n\0]*["\0]
 
 # Identifier
+# Identifiers may also hold XID_Start and XID_Continue code points, and string literals must be valid
+# UTF-8. The lexer hands both cases over to the hand-written lexer, which decodes them
 IDENTIFIER: [a-zA-Z_][a-zA-Z0-9_]*
 
 # Operators
-OP_PLUS: +
+OP_PLUS: \+
 OP_MINUS: -
-OP_MULT: *
+OP_MULT: \*
 OP_DIV: /
 OP_MOD: %
 OP_AND: and
 OP_OR: or
-OP_NOT: not
 OP_GT: >
 OP_GE: >=
 OP_EQ: ==
@@ -64,20 +71,29 @@ OP_LE: <=
 OP_LT: <
 
 # Misc
-SEMI_COLON: `;`
-COLON: `:`
-COMMA: `,`
-RANGE: `..`
-AMP: `&`
-NAMESPACE: `::`
-LBRACE: '{'
-RBRACE: '}'
-LBRACKET: '['
-RBRACKET: ']'
-LPAREN: '('
-RPAREN: ')'
+DOT: \.
+SEMI_COLON: ;
+COLON: :
+COMMA: ,
+RANGE: \.\.
+AMP: &
+NAMESPACE: ::
+LBRACE: {
+RBRACE: }
+LBRACKET: \[
+RBRACKET: \]
+LPAREN: \(
+RPAREN: \)
 ASSIGN: =
 
 
 # Comment
-COMMENT: //.*
\ No newline at end of file
+COMMENT: //[^\n]*
+
+
+# Malformed tokens, reported and recovered from by the hand-written lexer
+
+## Number with a letter suffix
+UNKNOWN: [0-9]+[a-zA-Z]
+## String cut by a newline or by the end of the buffer
+UNKNOWN: "[^"\n\0]*
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <common/streamsource.hpp>
+#include <cstdint>
+#include <fstream>
+#include <parser/lexer.hpp>
+#include <string>
+#include <vector>
+
+namespace Crust {
+
+class CheckpointTest : public ::testing::Test {
+   protected:
+    // Saves after skip tokens, reads count more, restores and expects the same tokens and payloads again
+    static void expectSameTokensAfterRestore(Lexer& lexer, int skip, int count) {
+        for (int i = 0; i < skip; ++i) lexer.getNextToken();
+
+        const Lexer::Checkpoint checkpoint = lexer.save();
+        const SourceLocation location = lexer.GetCurrentLocation();
+        const std::uint64_t offset = lexer.getCurrentTokenOffset();
+        const Symbol symbol = lexer.getCurrentSymbol();
+
+        std::vector<Lexer::Token> ahead;
+        std::vector<std::uint64_t> offsets;
+        std::vector<Symbol> symbols;
+        for (int i = 0; i < count; ++i) {
+            ahead.push_back(lexer.getNextToken());
+            offsets.push_back(lexer.getCurrentTokenOffset());
+            symbols.push_back(lexer.getCurrentSymbol());
+        }
+
+        lexer.restore(checkpoint);
+        EXPECT_EQ(lexer.GetCurrentLocation(), location);
+        EXPECT_EQ(lexer.getCurrentTokenOffset(), offset);
+        EXPECT_EQ(lexer.getCurrentSymbol(), symbol);
+        for (std::size_t i = 0; i < ahead.size(); ++i) {
+            EXPECT_EQ(lexer.getNextToken(), ahead[i]) << "token " << i;
+            EXPECT_EQ(lexer.getCurrentTokenOffset(), offsets[i]) << "token " << i;
+            EXPECT_EQ(lexer.getCurrentSymbol(), symbols[i]) << "token " << i;
+        }
+    }
+};
+
+TEST_F(CheckpointTest, RestoresBufferLexer) {
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init("source_code/full/sort.crst"));
+    expectSameTokensAfterRestore(lexer, 10, 20);
+}
+
+// A stream lexer can go back as long as the checkpoint is still in its window
+TEST_F(CheckpointTest, RestoresStreamLexerInsideTheWindow) {
+    std::ifstream file("source_code/full/sort.crst");
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init(StreamSource::fromStream(file)));
+    expectSameTokensAfterRestore(lexer, 10, 20);
+}
+
+}  // namespace Crust
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <common/corpusgenerator.hpp>
+#include <common/sourcebuffer.hpp>
+#include <parser/lexer.hpp>
+#include <parser/parser.hpp>
+#include <parser/tokentable.hpp>
+#include <sstream>
+#include <string>
+
+namespace Crust {
+
+class CorpusGeneratorTest : public ::testing::Test {
+   protected:
+    static constexpr CorpusGenerator::Shape shapes[] = {
+        CorpusGenerator::Shape::FUNCTIONS,
+        CorpusGenerator::Shape::CONDITIONALS,
+        CorpusGenerator::Shape::DECLARATIONS,
+        CorpusGenerator::Shape::EXPRESSIONS,
+        CorpusGenerator::Shape::NESTING,
+        CorpusGenerator::Shape::MIXED,
+    };
+
+    // Lexes and parses contents, and expects neither to report anything
+    static void expectParses(const std::string& contents) {
+        Lexer lexer;
+        ASSERT_TRUE(lexer.init(SourceBuffer::fromString(contents)));
+
+        testing::internal::CaptureStdout();
+        testing::internal::CaptureStderr();
+        const TokenTable tokens = lexer.lexAll();
+        auto program = Parser().parseProgram(tokens);
+        const std::string output = testing::internal::GetCapturedStdout();
+        const std::string errors = testing::internal::GetCapturedStderr();
+
+        ASSERT_NE(program, nullptr);
+        EXPECT_EQ(errors, "");
+        EXPECT_EQ(output.find("Error"), std::string::npos);
+    }
+};
+
+TEST_F(CorpusGeneratorTest, GeneratesProgramsThatParse) {
+    for (CorpusGenerator::Shape shape : shapes) {
+        for (unsigned depth : {1, 3, 12}) {
+            SCOPED_TRACE(std::string(CorpusGenerator::getShapeName(shape)) + " depth " + std::to_string(depth));
+            expectParses(CorpusGenerator({shape, 8 << 10, depth, depth}).generate());
+        }
+    }
+}
+
+TEST_F(CorpusGeneratorTest, IsDeterministic) {
+    for (CorpusGenerator::Shape shape : shapes) {
+        CorpusGenerator generator({shape, 4 << 10, 4, 7});
+        const std::string source = generator.generate();
+        EXPECT_EQ(generator.generate(), source);
+        EXPECT_EQ(CorpusGenerator({shape, 4 << 10, 4, 7}).generate(), source);
+        EXPECT_NE(CorpusGenerator({shape, 4 << 10, 4, 8}).generate(), source);
+    }
+}
+
+TEST_F(CorpusGeneratorTest, StopsAfterTheRequestedSize) {
+    for (std::uint64_t size : {0, 1, 1000, 100000}) {
+        std::ostringstream out;
+        const std::uint64_t written = CorpusGenerator({CorpusGenerator::Shape::MIXED, size, 4, 1}).generate(out);
+        EXPECT_EQ(written, out.str().size());
+        EXPECT_GE(written, size);
+        EXPECT_LT(written, size + (8 << 10));
+    }
+}
+
+TEST_F(CorpusGeneratorTest, NamesShapes) {
+    for (CorpusGenerator::Shape shape : shapes)
+        EXPECT_EQ(CorpusGenerator::parseShape(CorpusGenerator::getShapeName(shape)), shape);
+    EXPECT_FALSE(CorpusGenerator::parseShape("Functions"));
+    EXPECT_FALSE(CorpusGenerator::parseShape(""));
+}
+
+}  // namespace Crust
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <parser/lexer.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Crust {
+
+class DfaLexerTest : public ::testing::Test {
+   protected:
+    // Lexes source with both backends and expects the same tokens, payloads and locations
+    static void expectSameTokens(std::shared_ptr<const SourceBuffer> source) {
+        Lexer handwritten;
+        Lexer dfa;
+        ASSERT_TRUE(handwritten.init(source));
+        ASSERT_TRUE(dfa.init(source));
+        dfa.setBackend(Lexer::Backend::DFA);
+
+        for (std::size_t idx = 0;; ++idx) {
+            const Lexer::Token expected = handwritten.getNextTokenAndComment();
+            ASSERT_EQ(dfa.getNextTokenAndComment(), expected) << "token " << idx;
+
+            ASSERT_EQ(dfa.getCurrentTokenOffset(), handwritten.getCurrentTokenOffset()) << "token " << idx;
+            ASSERT_EQ(dfa.getCurrentTokenLength(), handwritten.getCurrentTokenLength()) << "token " << idx;
+            ASSERT_EQ(dfa.GetCurrentLocation(), handwritten.GetCurrentLocation()) << "token " << idx;
+
+            if (expected == Lexer::Token::IDENTIFIER or expected == Lexer::Token::STR_LITERAL) {
+                ASSERT_EQ(dfa.getCurrentStr(), handwritten.getCurrentStr()) << "token " << idx;
+                ASSERT_EQ(dfa.getCurrentSymbol(), handwritten.getCurrentSymbol()) << "token " << idx;
+            } else if (expected == Lexer::Token::INT_LITERAL) {
+                ASSERT_EQ(dfa.getCurrentInt(), handwritten.getCurrentInt()) << "token " << idx;
+            } else if (expected == Lexer::Token::FLOAT_LITERAL) {
+                ASSERT_EQ(dfa.getCurrentFloat(), handwritten.getCurrentFloat()) << "token " << idx;
+            }
+
+            if (expected == Lexer::Token::TOK_EOF)
+                break;
+        }
+    }
+};
+
+TEST_F(DfaLexerTest, MatchesHandwrittenOnSourceCode) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator("source_code"))
+        if (entry.path().extension() == ".crst")
+            files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+    ASSERT_FALSE(files.empty());
+
+    for (const auto& file : files) {
+        SCOPED_TRACE(file.string());
+        expectSameTokens(SourceBuffer::fromFile(file.string()));
+    }
+}
+
+TEST_F(DfaLexerTest, MatchesHandwrittenOnMalformedTokens) {
+    for (const char* source : {"12abc = 4; x", "12abc", "1.", "1.\n2", "1..5", "3.x", "\"open", "\"line\nbreak\" y",
+                               "!", "!= !x", "@#$ `", "a\x80" "b", "..:::..", "// comment", "a//b\n/", "_9a __",
+                               "caf\xc3\xa9 = 1", "\xc3\xa9t\xc3\xa9", "a\xc3", "a\xe2\x82\xac", "\"\xc3\xa9\"", "\"\xc3(\" x"}) {
+        SCOPED_TRACE(source);
+        expectSameTokens(SourceBuffer::fromString(source));
+    }
+
+    SCOPED_TRACE("NUL bytes");
+    expectSameTokens(SourceBuffer::fromString(std::string("\"ab\0cd\" \0 x", 11)));
+}
+
+TEST_F(DfaLexerTest, MatchesHandwrittenOnRandomInput) {
+    // Every byte that starts or ends some token and pieces of UTF-8 sequences, with digits rare enough not to overflow an int
+    static const char bytes[] = "ab_zZ09 \t\n\".,:;&{}[]()=+-*/%<>!#\0\x80\xa9\xc3\xe2\xff";
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::size_t> pick(0, sizeof(bytes) - 2);
+
+    for (int round = 0; round < 500; ++round) {
+        std::string source(round % 64, ' ');
+        for (char& c : source) c = bytes[pick(rng)];
+
+        SCOPED_TRACE(source);
+        expectSameTokens(SourceBuffer::fromString(source));
+    }
+}
+
+}  // namespace Crust
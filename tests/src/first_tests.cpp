@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <CFG/first.hpp>
+
+namespace Crust {
+
+using Kind = CFGNode::NodeKind;
+using T = Lexer::Token;
+
+// Looked up at compile time
+static_assert(FirstSets::get(Kind::FN_DECL) == TokenSet{T::KW_FN});
+static_assert(FirstSets::get(Kind::TYPE).contains(T::KW_VOID));
+static_assert(!FirstSets::get(Kind::TYPE).contains(T::KW_TRUE));
+
+TEST(FirstSetsTest, TokenSetOperations) {
+    const TokenSet types = TokenSet::range(T::KW_INT_32, T::KW_VOID);
+    EXPECT_EQ(types.getBits(), 0x1ffu);
+    EXPECT_TRUE(TokenSet{}.empty());
+    EXPECT_FALSE(types.contains(T::LBRACKET));
+    EXPECT_TRUE((types | TokenSet{T::LBRACKET}).contains(T::LBRACKET));
+    EXPECT_TRUE((TokenSet{T::UNKNOWN}).contains(T::UNKNOWN));
+}
+
+TEST(FirstSetsTest, RulesThatMayBeEmptyAcceptTheirFollow) {
+    EXPECT_TRUE(FirstSets::get(Kind::STMT_LIST).contains(T::RBRACE));
+    EXPECT_TRUE(FirstSets::get(Kind::FN_PARAM_LIST).contains(T::RPAREN));
+    EXPECT_TRUE(FirstSets::get(Kind::CALL_PARAM_LIST).contains(T::RPAREN));
+    EXPECT_TRUE(FirstSets::get(Kind::RETURN_VAR).contains(T::SEMI_COLON));
+    EXPECT_TRUE(FirstSets::get(Kind::ELIF_BLOCKS).contains(T::KW_ELSE));
+    EXPECT_FALSE(FirstSets::get(Kind::STMT).contains(T::RBRACE));
+}
+
+TEST(FirstSetsTest, StatementsStartWithTypesOrExpressions) {
+    const TokenSet stmt = FirstSets::get(Kind::STMT);
+    for (T token : {T::KW_INT_32, T::KW_STRING, T::LBRACKET, T::IDENTIFIER, T::INT_LITERAL, T::LPAREN, T::OP_MINUS,
+                    T::KW_IF, T::KW_FOR, T::KW_WHILE, T::KW_RETURN, T::LBRACE})
+        EXPECT_TRUE(stmt.contains(token)) << (unsigned)token;
+    for (T token : {T::KW_FN, T::KW_ELSE, T::SEMI_COLON, T::OP_PLUS, T::TOK_EOF})
+        EXPECT_FALSE(stmt.contains(token)) << (unsigned)token;
+}
+
+TEST(FirstSetsTest, TokensAndErrorsHaveNoFirstSet) {
+    EXPECT_TRUE(FirstSets::get(Kind::TOKEN).empty());
+    EXPECT_TRUE(FirstSets::get(Kind::ERROR).empty());
+}
+
+}  // namespace Crust
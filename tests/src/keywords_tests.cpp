@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+
+#include <parser/keywords.hpp>
+#include <parser/lexer.hpp>
+#include <string>
+
+namespace Crust {
+
+class KeywordsTest : public ::testing::Test {
+   protected:
+    static Lexer::Token lexWord(const std::string& word) {
+        Lexer lexer;
+        lexer.init(SourceBuffer::fromString(word));
+        return lexer.getNextToken();
+    }
+};
+
+TEST_F(KeywordsTest, ClassifiesEveryKeyword) {
+    for (std::size_t i = Keywords::FIRST; i <= Keywords::LAST; ++i) {
+        const auto token = static_cast<Lexer::Token>(i);
+        const std::string_view spelling = Keywords::spellings[i - Keywords::FIRST];
+        EXPECT_EQ(Keywords::classify(spelling), token) << spelling;
+        EXPECT_EQ(lexWord(std::string(spelling)), token) << spelling;
+    }
+
+    EXPECT_EQ(Keywords::classify("and"), Lexer::Token::OP_AND);
+    EXPECT_EQ(Keywords::classify("or"), Lexer::Token::OP_OR);
+}
+
+TEST_F(KeywordsTest, RejectsIdentifiers) {
+    // Same length, first and last character as a keyword, prefixes, suffixes and case changes
+    for (const char* word : {"i2", "i", "i322", "ii32", "I32", "ix2", "whale", "wile", "returns", "retur", "fnn",
+                             "f", "an", "andd", "o", "oor", "els", "elf", "Else", "string_", "_string", "x", "_"}) {
+        EXPECT_EQ(Keywords::classify(word), Lexer::Token::IDENTIFIER) << word;
+        EXPECT_EQ(lexWord(word), Lexer::Token::IDENTIFIER) << word;
+    }
+}
+
+TEST_F(KeywordsTest, IsConstexpr) {
+    static_assert(Keywords::classify("while") == Lexer::Token::KW_WHILE);
+    static_assert(Keywords::classify("whilst") == Lexer::Token::IDENTIFIER);
+    static_assert(Keywords::classify("") == Lexer::Token::IDENTIFIER);
+}
+
+}  // namespace Crust
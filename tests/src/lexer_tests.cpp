@@ -2,6 +2,7 @@
 
 #include <parser/lexer.hpp>
 #include <string>
+#include <vector>
 
 namespace Crust {
 
@@ -17,17 +18,24 @@ class LexerTest : public ::testing::Test {
 
     void checkToken(Lexer::Token expectedToken) {
         mCurrentToken = mLexer.getNextToken();
-        EXPECT_EQ(mCurrentToken, expectedToken) << "[" << mLexer.GetCurrentLocation().getCurrentLine() << ":" << mLexer.GetCurrentLocation().getCurrentColumn() << "]"
+        const LineColumn position = mLexer.getSourceBuffer()->getLineColumn(mLexer.GetCurrentLocation());
+        EXPECT_EQ(mCurrentToken, expectedToken) << "[" << position.line << ":" << position.column << "]"
                                                 << "\tRec.: " << (int)mCurrentToken
                                                 << "\tExp.: " << (int)expectedToken << std::endl;
     }
 
-    void checkIntLiteral(int expectedLiteral) {
+    // Comments are only returned by getNextTokenAndComment
+    void checkComment() {
+        mCurrentToken = mLexer.getNextTokenAndComment();
+        EXPECT_EQ(mCurrentToken, Lexer::Token::COMMENT);
+    }
+
+    void checkIntLiteral(std::uint64_t expectedLiteral) {
         checkToken(Lexer::Token::INT_LITERAL);
         EXPECT_EQ(mLexer.getCurrentInt(), expectedLiteral);
     }
 
-    void checkFloatLiteral(float expectedLiteral) {
+    void checkFloatLiteral(double expectedLiteral) {
         checkToken(Lexer::Token::FLOAT_LITERAL);
         EXPECT_EQ(mLexer.getCurrentFloat(), expectedLiteral);
     }
@@ -67,18 +75,18 @@ TEST_F(LexerTest, ReturnsCorrectKeywords) {
     checkToken(Lexer::Token::KW_TRUE);
     checkToken(Lexer::Token::KW_FALSE);
     checkToken(Lexer::Token::KW_LET);
-    checkToken(Lexer::Token::KW_CONST);
+    checkIdentifier("const");  // No longer a keyword
     checkToken(Lexer::Token::KW_IF);
     checkToken(Lexer::Token::KW_ELIF);
     checkToken(Lexer::Token::KW_ELSE);
     checkToken(Lexer::Token::KW_FOR);
     checkToken(Lexer::Token::KW_WHILE);
-    checkToken(Lexer::Token::KW_BREAK);
-    checkToken(Lexer::Token::KW_CONTINUE);
+    checkIdentifier("break");     // No longer a keyword
+    checkIdentifier("continue");  // No longer a keyword
     checkToken(Lexer::Token::KW_FN);
     checkToken(Lexer::Token::KW_RETURN);
-    checkToken(Lexer::Token::KW_IMPORT);
-    checkToken(Lexer::Token::KW_EXPORT);
+    checkIdentifier("import");  // No longer a keyword
+    checkIdentifier("export");  // No longer a keyword
 
     checkToken(Lexer::Token::TOK_EOF);
 }
@@ -163,10 +171,10 @@ TEST_F(LexerTest, ReturnsCorrectMiscSymbols) {
     checkToken(Lexer::Token::RANGE);
     checkToken(Lexer::Token::ASSIGN);
     checkToken(Lexer::Token::NAMESPACE);
-    checkToken(Lexer::Token::LCURLYBRACE);
-    checkToken(Lexer::Token::RCURLYBRACE);
-    checkToken(Lexer::Token::LSQUAREBRACKET);
-    checkToken(Lexer::Token::RSQUAREBRACKET);
+    checkToken(Lexer::Token::LBRACE);
+    checkToken(Lexer::Token::RBRACE);
+    checkToken(Lexer::Token::LBRACKET);
+    checkToken(Lexer::Token::RBRACKET);
     checkToken(Lexer::Token::LPAREN);
     checkToken(Lexer::Token::RPAREN);
 
@@ -187,12 +195,12 @@ TEST_F(LexerTest, ReturnsCorrectMiscSymbols) {
 TEST_F(LexerTest, ReturnsCorrectComments) {
     useFile("basic/comments.crst");
 
-    checkToken(Lexer::Token::COMMENT);
-    checkToken(Lexer::Token::COMMENT);
-    checkToken(Lexer::Token::COMMENT);
-    checkToken(Lexer::Token::COMMENT);
-    checkToken(Lexer::Token::COMMENT);
-    checkToken(Lexer::Token::COMMENT);
+    checkComment();
+    checkComment();
+    checkComment();
+    checkComment();
+    checkComment();
+    checkComment();
 
     checkToken(Lexer::Token::TOK_EOF);
 }
@@ -200,7 +208,7 @@ TEST_F(LexerTest, ReturnsCorrectComments) {
 TEST_F(LexerTest, ReturnsSwapTokens) {
     useFile("full/swap.crst");
 
-    checkToken(Lexer::Token::KW_IMPORT);
+    checkIdentifier("import");  // No longer a keyword
 
     checkIdentifier("std");
     checkToken(Lexer::Token::SEMI_COLON);
@@ -213,7 +221,7 @@ TEST_F(LexerTest, ReturnsSwapTokens) {
     checkToken(Lexer::Token::LPAREN);
     checkToken(Lexer::Token::RPAREN);
 
-    checkToken(Lexer::Token::LCURLYBRACE);
+    checkToken(Lexer::Token::LBRACE);
 
     checkToken(Lexer::Token::KW_LET);
     checkIdentifier("a");
@@ -274,7 +282,7 @@ TEST_F(LexerTest, ReturnsSwapTokens) {
     checkToken(Lexer::Token::RPAREN);
     checkToken(Lexer::Token::SEMI_COLON);
 
-    checkToken(Lexer::Token::RCURLYBRACE);
+    checkToken(Lexer::Token::RBRACE);
 
     checkToken(Lexer::Token::TOK_EOF);
 }
@@ -282,7 +290,7 @@ TEST_F(LexerTest, ReturnsSwapTokens) {
 TEST_F(LexerTest, ReturnsFactorialTokens) {
     useFile("full/fact.crst");
 
-    checkToken(Lexer::Token::KW_IMPORT);
+    checkIdentifier("import");  // No longer a keyword
     checkIdentifier("std");
     checkToken(Lexer::Token::SEMI_COLON);
 
@@ -296,20 +304,20 @@ TEST_F(LexerTest, ReturnsFactorialTokens) {
     checkToken(Lexer::Token::KW_INT_32);
     checkToken(Lexer::Token::RPAREN);
 
-    checkToken(Lexer::Token::LCURLYBRACE);
+    checkToken(Lexer::Token::LBRACE);
 
     checkToken(Lexer::Token::KW_IF);
     checkIdentifier("n");
     checkToken(Lexer::Token::OP_EQ);
     checkIntLiteral(1);
 
-    checkToken(Lexer::Token::LCURLYBRACE);
+    checkToken(Lexer::Token::LBRACE);
 
     checkToken(Lexer::Token::KW_RETURN);
     checkIntLiteral(1);
     checkToken(Lexer::Token::SEMI_COLON);
 
-    checkToken(Lexer::Token::RCURLYBRACE);
+    checkToken(Lexer::Token::RBRACE);
 
     checkToken(Lexer::Token::KW_RETURN);
     checkIdentifier("n");
@@ -322,7 +330,7 @@ TEST_F(LexerTest, ReturnsFactorialTokens) {
     checkToken(Lexer::Token::RPAREN);
     checkToken(Lexer::Token::SEMI_COLON);
 
-    checkToken(Lexer::Token::RCURLYBRACE);
+    checkToken(Lexer::Token::RBRACE);
 
     checkToken(Lexer::Token::KW_FN);    // fn
     checkToken(Lexer::Token::COLON);    // :
@@ -331,7 +339,7 @@ TEST_F(LexerTest, ReturnsFactorialTokens) {
     checkToken(Lexer::Token::LPAREN);  // (
     checkToken(Lexer::Token::RPAREN);  // )
 
-    checkToken(Lexer::Token::LCURLYBRACE);
+    checkToken(Lexer::Token::LBRACE);
 
     checkToken(Lexer::Token::KW_LET);
     checkIdentifier("ans");
@@ -350,7 +358,7 @@ TEST_F(LexerTest, ReturnsFactorialTokens) {
     checkToken(Lexer::Token::RPAREN);
     checkToken(Lexer::Token::SEMI_COLON);
 
-    checkToken(Lexer::Token::RCURLYBRACE);
+    checkToken(Lexer::Token::RBRACE);
 
     checkToken(Lexer::Token::TOK_EOF);
 }
@@ -358,30 +366,30 @@ TEST_F(LexerTest, ReturnsFactorialTokens) {
 TEST_F(LexerTest, ReturnsCorrectSortTokens) {
     useFile("full/sort.crst");
 
-    checkToken(Lexer::Token::KW_IMPORT);  // import
+    checkIdentifier("import");  // No longer a keyword
     checkIdentifier("std");
     checkToken(Lexer::Token::SEMI_COLON);  // ;
 
-    checkToken(Lexer::Token::KW_FN);           // fn
-    checkToken(Lexer::Token::COLON);           // :
-    checkToken(Lexer::Token::LSQUAREBRACKET);  // [
-    checkToken(Lexer::Token::KW_INT_32);       // i32
-    checkToken(Lexer::Token::COMMA);           // ,
+    checkToken(Lexer::Token::KW_FN);      // fn
+    checkToken(Lexer::Token::COLON);      // :
+    checkToken(Lexer::Token::LBRACKET);   // [
+    checkToken(Lexer::Token::KW_INT_32);  // i32
+    checkToken(Lexer::Token::COMMA);      // ,
     checkIntLiteral(6);
-    checkToken(Lexer::Token::RSQUAREBRACKET);  // ]
+    checkToken(Lexer::Token::RBRACKET);  // ]
 
     checkIdentifier("bubbleSort");
     checkToken(Lexer::Token::LPAREN);  // (
     checkIdentifier("A");
-    checkToken(Lexer::Token::COLON);           // :
-    checkToken(Lexer::Token::LSQUAREBRACKET);  // [
-    checkToken(Lexer::Token::KW_INT_32);       // i32
-    checkToken(Lexer::Token::COMMA);           // ,
+    checkToken(Lexer::Token::COLON);      // :
+    checkToken(Lexer::Token::LBRACKET);   // [
+    checkToken(Lexer::Token::KW_INT_32);  // i32
+    checkToken(Lexer::Token::COMMA);      // ,
     checkIntLiteral(6);
-    checkToken(Lexer::Token::RSQUAREBRACKET);  // ]
-    checkToken(Lexer::Token::RPAREN);          // )
+    checkToken(Lexer::Token::RBRACKET);  // ]
+    checkToken(Lexer::Token::RPAREN);    // )
 
-    checkToken(Lexer::Token::LCURLYBRACE);  // {
+    checkToken(Lexer::Token::LBRACE);  // {
 
     //     // FUNCTION BODY
 
@@ -405,7 +413,7 @@ TEST_F(LexerTest, ReturnsCorrectSortTokens) {
     checkIntLiteral(1);
     checkToken(Lexer::Token::RPAREN);  // )
 
-    checkToken(Lexer::Token::LCURLYBRACE);  // {
+    checkToken(Lexer::Token::LBRACE);  // {
 
     checkToken(Lexer::Token::KW_FOR);  // for
     checkIdentifier("j");
@@ -420,28 +428,28 @@ TEST_F(LexerTest, ReturnsCorrectSortTokens) {
     checkIntLiteral(1);
     checkToken(Lexer::Token::RPAREN);  // )
 
-    checkToken(Lexer::Token::LCURLYBRACE);  // {
+    checkToken(Lexer::Token::LBRACE);  // {
 
     //     // IF
     checkToken(Lexer::Token::KW_IF);  // if
 
     checkIdentifier("A");
-    checkToken(Lexer::Token::LSQUAREBRACKET);  // [
+    checkToken(Lexer::Token::LBRACKET);  // [
     checkIdentifier("j");
-    checkToken(Lexer::Token::RSQUAREBRACKET);  // ]
+    checkToken(Lexer::Token::RBRACKET);  // ]
 
     checkToken(Lexer::Token::OP_GT);  // >
 
     checkIdentifier("A");
-    checkToken(Lexer::Token::LSQUAREBRACKET);  // [
+    checkToken(Lexer::Token::LBRACKET);  // [
     checkIdentifier("j");
     checkToken(Lexer::Token::OP_PLUS);  // +
     checkIntLiteral(1);
-    checkToken(Lexer::Token::RSQUAREBRACKET);  // ]
+    checkToken(Lexer::Token::RBRACKET);  // ]
 
-    checkToken(Lexer::Token::LCURLYBRACE);  // {
+    checkToken(Lexer::Token::LBRACE);  // {
 
-    checkToken(Lexer::Token::COMMENT);  //
+    // The // swap comment is skipped by getNextToken
 
     checkToken(Lexer::Token::KW_LET);  // let
     checkIdentifier("t");
@@ -449,45 +457,45 @@ TEST_F(LexerTest, ReturnsCorrectSortTokens) {
     checkToken(Lexer::Token::KW_INT_32);  // i32
     checkToken(Lexer::Token::ASSIGN);     // =
     checkIdentifier("A");
-    checkToken(Lexer::Token::LSQUAREBRACKET);  // [
+    checkToken(Lexer::Token::LBRACKET);  // [
     checkIdentifier("j");
-    checkToken(Lexer::Token::RSQUAREBRACKET);  // ]
-    checkToken(Lexer::Token::SEMI_COLON);      // ;
+    checkToken(Lexer::Token::RBRACKET);    // ]
+    checkToken(Lexer::Token::SEMI_COLON);  // ;
 
     checkIdentifier("A");
-    checkToken(Lexer::Token::LSQUAREBRACKET);  // [
+    checkToken(Lexer::Token::LBRACKET);  // [
     checkIdentifier("j");
-    checkToken(Lexer::Token::RSQUAREBRACKET);  // ]
-    checkToken(Lexer::Token::ASSIGN);          // =
+    checkToken(Lexer::Token::RBRACKET);  // ]
+    checkToken(Lexer::Token::ASSIGN);    // =
     checkIdentifier("A");
-    checkToken(Lexer::Token::LSQUAREBRACKET);  // [
+    checkToken(Lexer::Token::LBRACKET);  // [
     checkIdentifier("j");
     checkToken(Lexer::Token::OP_PLUS);  // +
     checkIntLiteral(1);
-    checkToken(Lexer::Token::RSQUAREBRACKET);  // ]
-    checkToken(Lexer::Token::SEMI_COLON);      // ;
+    checkToken(Lexer::Token::RBRACKET);    // ]
+    checkToken(Lexer::Token::SEMI_COLON);  // ;
 
     checkIdentifier("A");
-    checkToken(Lexer::Token::LSQUAREBRACKET);  // [
+    checkToken(Lexer::Token::LBRACKET);  // [
     checkIdentifier("j");
     checkToken(Lexer::Token::OP_PLUS);  // +
     checkIntLiteral(1);
-    checkToken(Lexer::Token::RSQUAREBRACKET);  // ]
-    checkToken(Lexer::Token::ASSIGN);          // =
+    checkToken(Lexer::Token::RBRACKET);  // ]
+    checkToken(Lexer::Token::ASSIGN);    // =
     checkIdentifier("t");
     checkToken(Lexer::Token::SEMI_COLON);  // ;
 
-    checkToken(Lexer::Token::RCURLYBRACE);  // }
+    checkToken(Lexer::Token::RBRACE);  // }
 
-    checkToken(Lexer::Token::RCURLYBRACE);  // }
+    checkToken(Lexer::Token::RBRACE);  // }
 
-    checkToken(Lexer::Token::RCURLYBRACE);  // }
+    checkToken(Lexer::Token::RBRACE);  // }
 
     checkToken(Lexer::Token::KW_RETURN);  // return
     checkIdentifier("A");
     checkToken(Lexer::Token::SEMI_COLON);  // ;
 
-    checkToken(Lexer::Token::RCURLYBRACE);  // }
+    checkToken(Lexer::Token::RBRACE);  // }
 
     // // MAIN FUNCTION
 
@@ -498,19 +506,19 @@ TEST_F(LexerTest, ReturnsCorrectSortTokens) {
     checkToken(Lexer::Token::LPAREN);  // (
     checkToken(Lexer::Token::RPAREN);  // )
 
-    checkToken(Lexer::Token::LCURLYBRACE);  // {
+    checkToken(Lexer::Token::LBRACE);  // {
 
     checkToken(Lexer::Token::KW_LET);  // let
     checkIdentifier("A");
-    checkToken(Lexer::Token::COLON);           // :
-    checkToken(Lexer::Token::LSQUAREBRACKET);  // [
-    checkToken(Lexer::Token::KW_INT_32);       // i32
-    checkToken(Lexer::Token::COMMA);           // ,
+    checkToken(Lexer::Token::COLON);      // :
+    checkToken(Lexer::Token::LBRACKET);   // [
+    checkToken(Lexer::Token::KW_INT_32);  // i32
+    checkToken(Lexer::Token::COMMA);      // ,
     checkIntLiteral(6);
-    checkToken(Lexer::Token::RSQUAREBRACKET);  // ]
-    checkToken(Lexer::Token::ASSIGN);          // =
+    checkToken(Lexer::Token::RBRACKET);  // ]
+    checkToken(Lexer::Token::ASSIGN);    // =
 
-    checkToken(Lexer::Token::LCURLYBRACE);
+    checkToken(Lexer::Token::LBRACE);
 
     checkIntLiteral(7);
     checkToken(Lexer::Token::COMMA);
@@ -529,7 +537,7 @@ TEST_F(LexerTest, ReturnsCorrectSortTokens) {
 
     checkIntLiteral(3);
 
-    checkToken(Lexer::Token::RCURLYBRACE);
+    checkToken(Lexer::Token::RBRACE);
     checkToken(Lexer::Token::SEMI_COLON);
 
     checkIdentifier("A");
@@ -546,7 +554,7 @@ TEST_F(LexerTest, ReturnsCorrectSortTokens) {
     checkToken(Lexer::Token::RPAREN);      // )
     checkToken(Lexer::Token::SEMI_COLON);  // ;
 
-    checkToken(Lexer::Token::RCURLYBRACE);  // }
+    checkToken(Lexer::Token::RBRACE);  // }
 
     checkToken(Lexer::Token::TOK_EOF);
 }
@@ -586,5 +594,4 @@ TEST_F(LexerTest, CausesNumberBadSuffixError) {
 
     checkToken(Lexer::Token::TOK_EOF);
 }
-
-}  // namespace Crust
\ No newline at end of file
+}  // namespace Crust
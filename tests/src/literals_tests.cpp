@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <parser/lexer.hpp>
+#include <string>
+
+namespace Crust {
+
+class LiteralsTest : public ::testing::Test {
+   protected:
+    void useFile(const std::string& filename, Lexer::Backend backend) {
+        ASSERT_TRUE(mLexer.init("source_code/" + filename));
+        mLexer.setBackend(backend);
+    }
+
+    void checkToken(Lexer::Token expectedToken) { EXPECT_EQ(mLexer.getNextToken(), expectedToken); }
+
+    void checkIntLiteral(std::uint64_t expectedLiteral) {
+        checkToken(Lexer::Token::INT_LITERAL);
+        EXPECT_EQ(mLexer.getCurrentInt(), expectedLiteral);
+    }
+
+    void checkFloatLiteral(double expectedLiteral) {
+        checkToken(Lexer::Token::FLOAT_LITERAL);
+        EXPECT_EQ(mLexer.getCurrentFloat(), expectedLiteral);
+    }
+
+    Lexer mLexer;
+};
+
+TEST_F(LiteralsTest, ReturnsWideLiterals) {
+    for (auto backend : {Lexer::Backend::HANDWRITTEN, Lexer::Backend::DFA}) {
+        useFile("basic/wide_literals.crst", backend);
+        testing::internal::CaptureStderr();
+        checkIntLiteral(4294967296ull);
+        checkIntLiteral(18446744073709551615ull);
+        checkFloatLiteral(1.5);
+        checkFloatLiteral(1e300);
+        checkToken(Lexer::Token::TOK_EOF);
+        EXPECT_EQ(testing::internal::GetCapturedStderr(), "");
+    }
+}
+
+// A literal that does not fit keeps a 0 payload and is reported once, just past its end
+TEST_F(LiteralsTest, CausesNumberOutOfRangeError) {
+    for (auto backend : {Lexer::Backend::HANDWRITTEN, Lexer::Backend::DFA}) {
+        useFile("errors/range.crst", backend);
+        testing::internal::CaptureStderr();
+
+        checkToken(Lexer::Token::KW_LET);
+        checkToken(Lexer::Token::IDENTIFIER);
+        checkToken(Lexer::Token::COLON);
+        checkToken(Lexer::Token::KW_UINT_64);
+        checkToken(Lexer::Token::ASSIGN);
+        checkIntLiteral(0);  // Does not fit in 64 bits
+        checkToken(Lexer::Token::SEMI_COLON);
+
+        checkToken(Lexer::Token::KW_LET);
+        checkToken(Lexer::Token::IDENTIFIER);
+        checkToken(Lexer::Token::COLON);
+        checkToken(Lexer::Token::KW_FLOAT_64);
+        checkToken(Lexer::Token::ASSIGN);
+        checkFloatLiteral(0);  // Does not fit in a double
+        checkToken(Lexer::Token::SEMI_COLON);
+
+        checkToken(Lexer::Token::TOK_EOF);
+        EXPECT_EQ(testing::internal::GetCapturedStderr(),
+                  "LITERAL ERROR: Number literal out of range at line 1, column 34\n"
+                  "LITERAL ERROR: Number literal out of range at line 2, column 20\n");
+    }
+}
+
+}  // namespace Crust
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <common/corpusgenerator.hpp>
+#include <common/sourcebuffer.hpp>
+#include <filesystem>
+#include <parser/lexer.hpp>
+#include <parser/parser.hpp>
+#include <parser/tokentable.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Crust {
+
+class LLParserTest : public ::testing::Test {
+   protected:
+    struct Result {
+        std::string tree;
+        std::string output; /*!< Printed on stdout */
+        std::string errors; /*!< Printed on stderr */
+    };
+
+    static Result parse(const TokenTable& tokens, Parser::Backend backend) {
+        Parser parser;
+        parser.setBackend(backend);
+        testing::internal::CaptureStdout();
+        testing::internal::CaptureStderr();
+        const auto program = parser.parseProgram(tokens);
+        Result result;
+        result.errors = testing::internal::GetCapturedStderr();
+        result.output = testing::internal::GetCapturedStdout();
+        describe(program.get(), result.tree);
+        return result;
+    }
+
+    // Parses source with both backends and expects the same tree and the same diagnostics
+    static void expectSameTree(std::shared_ptr<const SourceBuffer> source) {
+        Lexer lexer;
+        ASSERT_TRUE(lexer.init(std::move(source)));
+        testing::internal::CaptureStderr();
+        const TokenTable tokens = lexer.lexAll();
+        testing::internal::GetCapturedStderr();
+
+        const Result expected = parse(tokens, Parser::Backend::HANDWRITTEN);
+        const Result received = parse(tokens, Parser::Backend::TABLE);
+        EXPECT_EQ(received.tree, expected.tree);
+        EXPECT_EQ(received.output, expected.output);
+        EXPECT_EQ(received.errors, expected.errors);
+    }
+
+    // Names of the nodes in prefix order, null for a missing child
+    static void describe(const CFGNode* node, std::string& out) {
+        if (!node) {
+            out += "null ";
+            return;
+        }
+        out += node->getName() + "( ";
+        for (const auto& child : node->getChildrenNodes()) describe(child.get(), out);
+        out += ") ";
+    }
+};
+
+TEST_F(LLParserTest, MatchesHandwrittenOnSourceCode) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator("source_code"))
+        if (entry.path().extension() == ".crst")
+            files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+    ASSERT_FALSE(files.empty());
+
+    for (const auto& file : files) {
+        SCOPED_TRACE(file.string());
+        expectSameTree(SourceBuffer::fromFile(file.string()));
+    }
+}
+
+TEST_F(LLParserTest, MatchesHandwrittenOnGeneratedPrograms) {
+    for (auto shape : {CorpusGenerator::Shape::FUNCTIONS, CorpusGenerator::Shape::CONDITIONALS, CorpusGenerator::Shape::DECLARATIONS,
+                       CorpusGenerator::Shape::EXPRESSIONS, CorpusGenerator::Shape::NESTING, CorpusGenerator::Shape::MIXED}) {
+        SCOPED_TRACE(std::string(CorpusGenerator::getShapeName(shape)));
+        expectSameTree(SourceBuffer::fromString(CorpusGenerator({shape, 16 << 10, 6, 1}).generate()));
+    }
+}
+
+TEST_F(LLParserTest, MatchesHandwrittenOnMalformedPrograms) {
+    for (const char* source : {"", "fn", "fn f(", "fn f() void", "fn f() void {", "i32", "i32 a, b,", "i32 a b;", "[4] i32 a;",
+                               "[4 i32 a;", "fn f(i32 a,) void {}", "fn f(i32, i32 b) void {}", "fn f() void { g(1,); }",
+                               "fn f() void { a = ; }", "fn f() void { a[1 = 2; }", "fn f() void { -a; }", "fn f() void { -1 + 2; }",
+                               "fn f() void { (1 + 2; }", "fn f() void { if a { } elif { } else }", "fn f() void { else { } }",
+                               "fn f() void { for i in \"a\"..2 { } }", "fn f() void { for i in 1..2..3 { } }", "fn f() void { for i 1..2 {} }",
+                               "fn f() void { while { } }", "fn f() void { return }", "fn f() void { return 1 }", "} ; fn",
+                               "fn f() void { x y z; }", "fn f() void { f(g(h(1), 2) ; }", "let a = 3;", "fn f() i32 { return a.b; }"}) {
+        SCOPED_TRACE(source);
+        expectSameTree(SourceBuffer::fromString(source));
+    }
+}
+
+TEST_F(LLParserTest, MatchesHandwrittenOnMutatedPrograms) {
+    const std::string program = CorpusGenerator({CorpusGenerator::Shape::MIXED, 1 << 10, 3, 9}).generate();
+    std::mt19937 rng(5);
+
+    for (int round = 0; round < 300; ++round) {
+        // Cut a slice out of the program, then drop or repeat a few spans of it
+        std::uniform_int_distribution<std::size_t> offset(0, program.size());
+        std::size_t begin = offset(rng);
+        std::size_t end = offset(rng);
+        if (begin > end)
+            std::swap(begin, end);
+        std::string source = program.substr(begin, end - begin);
+
+        for (int edit = 0; edit < 3 and !source.empty(); ++edit) {
+            std::uniform_int_distribution<std::size_t> at(0, source.size() - 1);
+            const std::size_t from = at(rng);
+            const std::size_t length = std::min<std::size_t>(rng() % 8, source.size() - from);
+            if (rng() % 2)
+                source.erase(from, length);
+            else
+                source.insert(from, source.substr(from, length));
+        }
+
+        SCOPED_TRACE(source);
+        expectSameTree(SourceBuffer::fromString(source));
+    }
+}
+
+TEST_F(LLParserTest, ParsesFilesAndStreams) {
+    const std::string path = "source_code/full/fact.crst";
+    Parser handwritten;
+    Parser table;
+    table.setBackend(Parser::Backend::TABLE);
+    EXPECT_EQ(table.getBackend(), Parser::Backend::TABLE);
+
+    std::string expected;
+    std::string received;
+    describe(handwritten.parseProgram(path).get(), expected);
+    describe(table.parseProgram(path).get(), received);
+    EXPECT_EQ(received, expected);
+
+    received.clear();
+    table.setPipelined(true);
+    describe(table.parseProgram(path).get(), received);
+    EXPECT_EQ(received, expected);
+}
+
+}  // namespace Crust
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <parser/lexer.hpp>
+#include <parser/tokentable.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Crust {
+
+class ParallelLexerTest : public ::testing::Test {
+   protected:
+    static std::string readWholeFile(const std::string& filename) {
+        std::ifstream stream(filename);
+        return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    // Lexes source with lexAll and with lexAllParallel, and expects the same tables and diagnostics
+    static void expectSameTokens(const std::string& contents, unsigned threads, std::size_t minChunkSize) {
+        auto source = SourceBuffer::fromString(contents);
+
+        Lexer sequential;
+        ASSERT_TRUE(sequential.init(source));
+        testing::internal::CaptureStderr();
+        const TokenTable expected = sequential.lexAll(true);
+        const std::string expectedErrors = testing::internal::GetCapturedStderr();
+
+        Lexer parallel;
+        ASSERT_TRUE(parallel.init(source));
+        testing::internal::CaptureStderr();
+        const TokenTable tokens = parallel.lexAllParallel(threads, true, minChunkSize);
+        EXPECT_EQ(testing::internal::GetCapturedStderr(), expectedErrors);
+
+        ASSERT_EQ(tokens.size(), expected.size());
+        for (std::size_t idx = 0; idx < tokens.size(); ++idx) {
+            ASSERT_EQ(tokens.getKind(idx), expected.getKind(idx)) << "token " << idx;
+            ASSERT_EQ(tokens.getOffset(idx), expected.getOffset(idx)) << "token " << idx;
+            ASSERT_EQ(tokens.getLength(idx), expected.getLength(idx)) << "token " << idx;
+            ASSERT_EQ(tokens.getPayloadIndex(idx), expected.getPayloadIndex(idx)) << "token " << idx;
+
+            if (expected.getKind(idx) == Lexer::Token::INT_LITERAL) {
+                ASSERT_EQ(tokens.getInt(idx), expected.getInt(idx)) << "token " << idx;
+            } else if (expected.getKind(idx) == Lexer::Token::FLOAT_LITERAL) {
+                ASSERT_EQ(tokens.getFloat(idx), expected.getFloat(idx)) << "token " << idx;
+            }
+        }
+        EXPECT_EQ(parallel.GetCurrentLocation(), sequential.GetCurrentLocation());
+    }
+};
+
+TEST_F(ParallelLexerTest, MatchesLexAllOnSourceCode) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator("source_code"))
+        if (entry.path().extension() == ".crst")
+            files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+    ASSERT_FALSE(files.empty());
+
+    for (const auto& file : files) {
+        const std::string contents = readWholeFile(file.string());
+        for (unsigned threads : {2, 3, 8}) {
+            SCOPED_TRACE(file.string() + " threads " + std::to_string(threads));
+            expectSameTokens(contents, threads, 1);
+        }
+    }
+}
+
+TEST_F(ParallelLexerTest, RepairsTokensCrossingChunks) {
+    // Every token the lexer lets run past a newline, followed by lines that lex differently out of step
+    const std::string tails = "x = 1;\n\"a\" y\n12 + b\n// c \"\n";
+    for (const char* head : {"\"open\n", "\"open\n\n\n\"", "12abc\n\n", "1.\n", "x = \"multi\nline\" ;\n"}) {
+        std::string contents = head;
+        for (int i = 0; i < 8; ++i) contents += tails + head;
+
+        for (unsigned threads : {2, 5, 16}) {
+            SCOPED_TRACE(std::string(head) + " threads " + std::to_string(threads));
+            expectSameTokens(contents, threads, 1);
+        }
+    }
+}
+
+TEST_F(ParallelLexerTest, MatchesLexAllOnRandomInput) {
+    static const char bytes[] = "ab_z09 \n\n\n\".:;{}=+/<!#";
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<std::size_t> pick(0, sizeof(bytes) - 2);
+
+    for (int round = 0; round < 200; ++round) {
+        std::string source(16 + round % 200, ' ');
+        for (char& c : source) c = bytes[pick(rng)];
+
+        SCOPED_TRACE(source);
+        expectSameTokens(source, 2 + round % 7, 1);
+    }
+}
+
+TEST_F(ParallelLexerTest, FallsBackToLexAllOnSmallInputs) {
+    expectSameTokens("let x: i32 = 4;", 8, 1 << 16);
+    expectSameTokens("", 8, 1);
+}
+
+}  // namespace Crust
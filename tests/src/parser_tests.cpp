@@ -0,0 +1,283 @@
+#include <gtest/gtest.h>
+
+#include <common/sourcebuffer.hpp>
+#include <memory>
+#include <parser/lexer.hpp>
+#include <parser/parser.hpp>
+#include <parser/tokentable.hpp>
+#include <string>
+#include <vector>
+
+namespace Crust {
+
+class ParserTest : public ::testing::Test {
+   protected:
+    std::unique_ptr<CFGNode> parse(const std::string& source, Parser::Backend backend = Parser::Backend::HANDWRITTEN) {
+        Lexer lexer;
+        EXPECT_TRUE(lexer.init(SourceBuffer::fromString(source)));
+        mTokens = lexer.lexAll();
+        Parser parser;
+        parser.setBackend(backend);
+        return parser.parseProgram(mTokens);
+    }
+
+    // First node of kind in prefix order, or nullptr
+    static const CFGNode* find(const CFGNode* node, CFGNode::NodeKind kind) {
+        if (!node or node->getKind() == kind)
+            return node;
+        for (const auto& child : node->getChildrenNodes())
+            if (const CFGNode* found = find(child.get(), kind))
+                return found;
+        return nullptr;
+    }
+
+    // Kinds of the children of node, TOKEN children spelled by their token
+    static std::string childKinds(const CFGNode* node) {
+        std::string kinds;
+        for (const auto& child : node->getChildrenNodes()) {
+            if (!kinds.empty())
+                kinds += ' ';
+            kinds += child->getName();
+        }
+        return kinds;
+    }
+
+    // The expression of the statement `v = <expression>;` with every BINARY_EXPRESSION in parentheses,
+    // tokens spelled by their identifier or their token name
+    std::string infix(const std::string& expression, Parser::Backend backend = Parser::Backend::HANDWRITTEN) {
+        const auto program = parse("fn f() void {\n    v = " + expression + ";\n}\n", backend);
+        return infix(find(program.get(), CFGNode::NodeKind::EXPRESSION));
+    }
+
+    static std::string infix(const CFGNode* node) {
+        const auto& children = node->getChildrenNodes();
+        if (children.empty()) {
+            const std::string name = node->getName();
+            const std::size_t open = name.find('(');
+            return open == std::string::npos ? name.substr(name.find('_') + 1) : name.substr(open + 1, name.size() - open - 2);
+        }
+
+        std::string out;
+        for (const auto& child : children) {
+            if (!out.empty())
+                out += ' ';
+            out += infix(child.get());
+        }
+        return node->getKind() == CFGNode::NodeKind::BINARY_EXPRESSION ? "(" + out + ")" : out;
+    }
+
+   private:
+    TokenTable mTokens;
+};
+
+TEST_F(ParserTest, FlattensLists) {
+    const auto program = parse(
+        "i32 a, b, c;\n"
+        "fn f(i32 x, bool y, f64 z) void {\n"
+        "    a = g(1, x, 3);\n"
+        "    b = 2;\n"
+        "    return;\n"
+        "}\n");
+    ASSERT_EQ(program->getChildrenNodes().size(), 1u);
+
+    const CFGNode* decls = program->getChildrenNodes()[0].get();
+    EXPECT_EQ(childKinds(decls), "DECL DECL");
+    EXPECT_EQ(childKinds(find(program.get(), CFGNode::NodeKind::VAR_DECL_LIST)),
+              "TOKEN_IDENTIFIER(a) TOKEN_COMMA TOKEN_IDENTIFIER(b) TOKEN_COMMA TOKEN_IDENTIFIER(c)");
+    EXPECT_EQ(childKinds(find(program.get(), CFGNode::NodeKind::FN_PARAM_LIST)),
+              "FN_PARAM TOKEN_COMMA FN_PARAM TOKEN_COMMA FN_PARAM");
+    EXPECT_EQ(childKinds(find(program.get(), CFGNode::NodeKind::CALL_PARAM_LIST)),
+              "EXPRESSION TOKEN_COMMA EXPRESSION TOKEN_COMMA EXPRESSION");
+    EXPECT_EQ(childKinds(find(program.get(), CFGNode::NodeKind::STMT_LIST)), "STMT STMT STMT");
+}
+
+TEST_F(ParserTest, EmptyLists) {
+    const auto program = parse("fn f() void {\n    g();\n}\n");
+    EXPECT_TRUE(find(program.get(), CFGNode::NodeKind::FN_PARAM_LIST)->getChildrenNodes().empty());
+    EXPECT_TRUE(find(program.get(), CFGNode::NodeKind::CALL_PARAM_LIST)->getChildrenNodes().empty());
+
+    EXPECT_TRUE(parse("")->getChildrenNodes()[0]->getChildrenNodes().empty());
+}
+
+TEST_F(ParserTest, ListEndingAfterComma) {
+    testing::internal::CaptureStderr();
+    const auto program = parse("i32 a, b,");
+    testing::internal::GetCapturedStderr();
+
+    EXPECT_EQ(childKinds(find(program.get(), CFGNode::NodeKind::VAR_DECL_LIST)),
+              "TOKEN_IDENTIFIER(a) TOKEN_COMMA TOKEN_IDENTIFIER(b) TOKEN_COMMA ERROR");
+}
+
+// Lists no longer recurse once per element, so their length does not grow the stack
+TEST_F(ParserTest, LongLists) {
+    constexpr std::size_t count = 100000;
+
+    std::string decls;
+    for (std::size_t idx = 0; idx < count; ++idx) decls += "i32 v" + std::to_string(idx) + ";\n";
+    EXPECT_EQ(parse(decls)->getChildrenNodes()[0]->getChildrenNodes().size(), count);
+
+    std::string stmts = "fn f() void {\n";
+    for (std::size_t idx = 0; idx < count; ++idx) stmts += "    v = " + std::to_string(idx) + ";\n";
+    stmts += "}\n";
+    const auto program = parse(stmts);
+    EXPECT_EQ(find(program.get(), CFGNode::NodeKind::STMT_LIST)->getChildrenNodes().size(), count);
+
+    std::string vars = "i32 v0";
+    for (std::size_t idx = 1; idx < count; ++idx) vars += ", v" + std::to_string(idx);
+    vars += ";\n";
+    EXPECT_EQ(find(parse(vars).get(), CFGNode::NodeKind::VAR_DECL_LIST)->getChildrenNodes().size(), 2 * count - 1);
+}
+
+// A negative number ends the term, the token after it is left to the caller
+TEST_F(ParserTest, NegativeNumbers) {
+    testing::internal::CaptureStdout();
+    testing::internal::CaptureStderr();
+    const auto program = parse("fn f() f64 {\n    g(-1, 2);\n    return -1.5;\n}\n");
+    const std::string errors = testing::internal::GetCapturedStderr();
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+    EXPECT_EQ(errors, "");
+
+    EXPECT_EQ(childKinds(find(program.get(), CFGNode::NodeKind::CALL_PARAM_LIST)), "EXPRESSION TOKEN_COMMA EXPRESSION");
+    EXPECT_EQ(childKinds(find(find(program.get(), CFGNode::NodeKind::CALL_PARAM_LIST), CFGNode::NodeKind::TERM)),
+              "TOKEN_OP_MINUS FLOAT_TERM");
+}
+
+// A range may start with any term, a string literal included
+TEST_F(ParserTest, StringLoopRanges) {
+    testing::internal::CaptureStdout();
+    testing::internal::CaptureStderr();
+    const auto program = parse("fn f() void {\n    for c in \"a\"..\"z\" {\n    }\n}\n");
+    const std::string errors = testing::internal::GetCapturedStderr();
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+    EXPECT_EQ(errors, "");
+
+    EXPECT_EQ(childKinds(find(program.get(), CFGNode::NodeKind::LOOP_RANGE)), "EXPRESSION TOKEN_RANGE EXPRESSION LOOP_STEP");
+}
+
+TEST_F(ParserTest, OperatorPrecedence) {
+    for (auto backend : {Parser::Backend::HANDWRITTEN, Parser::Backend::TABLE}) {
+        EXPECT_EQ(infix("a", backend), "a");
+        EXPECT_EQ(infix("a + b * c - d", backend), "((a OP_PLUS (b OP_MULT c)) OP_MINUS d)");
+        EXPECT_EQ(infix("a * b + c * d < e", backend), "(((a OP_MULT b) OP_PLUS (c OP_MULT d)) OP_LT e)");
+        EXPECT_EQ(infix("a or b and c == d < e + f * g", backend),
+                  "(a OP_OR (b OP_AND (c OP_EQ (d OP_LT (e OP_PLUS (f OP_MULT g))))))");
+        EXPECT_EQ(infix("a * b + c == d - e or f", backend), "((((a OP_MULT b) OP_PLUS c) OP_EQ (d OP_MINUS e)) OP_OR f)");
+        EXPECT_EQ(infix("(a + b) * c", backend), "(LPAREN (a OP_PLUS b) RPAREN OP_MULT c)");
+    }
+}
+
+TEST_F(ParserTest, LeftAssociativeOperators) {
+    for (auto backend : {Parser::Backend::HANDWRITTEN, Parser::Backend::TABLE}) {
+        EXPECT_EQ(infix("a - b - c", backend), "((a OP_MINUS b) OP_MINUS c)");
+        EXPECT_EQ(infix("a / b * c % d", backend), "(((a OP_DIV b) OP_MULT c) OP_MOD d)");
+        EXPECT_EQ(infix("a < b != c == d", backend), "(((a OP_LT b) OP_NE c) OP_EQ d)");
+        EXPECT_EQ(infix("a or b or c and d and e", backend), "((a OP_OR b) OP_OR ((c OP_AND d) OP_AND e))");
+    }
+}
+
+// Operators are folded in a loop, so the length of an expression does not grow the stack of the parser
+TEST_F(ParserTest, LongExpressions) {
+    constexpr std::size_t count = 10000;
+    const char* const operators[] = {" * ", " + ", " < ", " == ", " and ", " or ", " - ", " / "};
+
+    std::string expression = "v0";
+    for (std::size_t idx = 1; idx < count; ++idx) expression += operators[idx % 8] + ("v" + std::to_string(idx));
+    const std::string source = "fn f() void {\n    v = " + expression + ";\n}\n";
+
+    for (auto backend : {Parser::Backend::HANDWRITTEN, Parser::Backend::TABLE}) {
+        testing::internal::CaptureStderr();
+        const auto program = parse(source, backend);
+        EXPECT_EQ(testing::internal::GetCapturedStderr(), "");
+
+        // One BINARY_EXPRESSION per operator, the last `or` at the root
+        std::size_t binaries = 0;
+        std::vector<const CFGNode*> pending{find(program.get(), CFGNode::NodeKind::EXPRESSION)};
+        while (!pending.empty()) {
+            const CFGNode* node = pending.back();
+            pending.pop_back();
+            binaries += node->getKind() == CFGNode::NodeKind::BINARY_EXPRESSION;
+            for (const auto& child : node->getChildrenNodes()) pending.push_back(child.get());
+        }
+        EXPECT_EQ(binaries, count - 1);
+    }
+
+    std::string chain = "v0";
+    for (std::size_t idx = 1; idx < count; ++idx) chain += " + v" + std::to_string(idx);
+    EXPECT_NE(find(parse("fn f() void {\n    v = " + chain + ";\n}\n").get(), CFGNode::NodeKind::BINARY_EXPRESSION), nullptr);
+}
+
+// The tree of a long chain is as deep as the chain is long, tearing it down must not recurse
+TEST_F(ParserTest, DestroysMillionTermChains) {
+    constexpr std::size_t count = 1000000;
+
+    std::string chain = "v0";
+    for (std::size_t idx = 1; idx < count; ++idx) chain += " + v" + std::to_string(idx);
+    auto program = parse("fn f() void {\n    v = " + chain + ";\n}\n");
+
+    // Left-leaning, one BINARY_EXPRESSION per + down the left operands
+    std::size_t depth = 0;
+    const CFGNode* node = find(program.get(), CFGNode::NodeKind::BINARY_EXPRESSION);
+    for (; node and node->getKind() == CFGNode::NodeKind::BINARY_EXPRESSION; node = node->getChildrenNodes().front().get()) ++depth;
+    EXPECT_EQ(depth, count - 1);
+
+    program.reset();
+}
+
+// Drives the lookahead ring of a parser reading a source through mLexer or a pipeline, as parseProgram does
+class ParserLookaheadTest : public ::testing::Test {
+   protected:
+    void start(const std::shared_ptr<const SourceBuffer>& source, bool pipelined) {
+        ASSERT_TRUE(mParser.mLexer.init(source));
+        mParser.mTokens = nullptr;
+        mParser.mLookaheadSize = 0;
+        mParser.mPipeline = pipelined ? std::make_unique<TokenPipeline>(source, 3, 2) : nullptr;
+        mParser.mCurrentToken = mParser.nextToken();
+    }
+    void stop() { mParser.mPipeline = nullptr; }
+
+    Lexer::Token peek(std::size_t k) { return mParser.peek(k); }
+    Lexer::Token nextToken() { return mParser.mCurrentToken = mParser.nextToken(); }
+    const LexedToken& current() const { return mParser.mCurrent; }
+
+    static constexpr std::size_t LOOKAHEAD = Parser::LOOKAHEAD;
+
+    Parser mParser;
+};
+
+TEST_F(ParserLookaheadTest, PeeksAcrossTheRingUpToEof) {
+    const auto source = SourceBuffer::fromString(
+        "fn f(a: i64) f64 {\n    let s: str = \"ring\";\n    x = a * 42 + 1.5 - g(a, \"wrap\", 7);\n    return x;\n}\n");
+
+    // What the ring has to give back, TOK_EOF last
+    std::vector<LexedToken> expected;
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init(source));
+    for (Lexer::Token kind = Lexer::Token::UNKNOWN; kind != Lexer::Token::TOK_EOF;) {
+        kind = lexer.getNextToken();
+        expected.push_back(LexedToken::fromLexer(lexer, kind));
+    }
+    const auto expectedKind = [&](std::size_t idx) {
+        return idx < expected.size() ? expected[idx].kind : Lexer::Token::TOK_EOF;
+    };
+
+    for (bool pipelined : {false, true}) {
+        SCOPED_TRACE(pipelined ? "pipelined" : "lexer");
+        start(source, pipelined);
+        ASSERT_EQ(current(), expected[0]);
+
+        // Varying how far ahead is peeked moves the start of the ring around it, past the end of the source
+        for (std::size_t idx = 0; idx < expected.size() + LOOKAHEAD; ++idx) {
+            const std::size_t depth = 2 + idx % (LOOKAHEAD - 1);
+            for (std::size_t k = depth; k >= 1; --k) EXPECT_EQ(peek(k), expectedKind(idx + k)) << "token " << idx << ", k " << k;
+
+            const std::size_t next = std::min(idx + 1, expected.size() - 1);
+            EXPECT_EQ(nextToken(), expected[next].kind) << "token " << idx;
+            EXPECT_EQ(current(), expected[next]) << "token " << idx;
+            EXPECT_EQ(peek(1), expectedKind(idx + 2)) << "token " << idx;
+            EXPECT_EQ(current(), expected[next]) << "token " << idx;
+        }
+        stop();
+    }
+}
+
+}  // namespace Crust
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <parser/lexer.hpp>
+#include <parser/scan.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Crust {
+
+namespace {
+
+// Scanned by a static initializer, before anything picked the kernels
+const char gStaticInput[] = " \t\n x";
+const char* const gSkippedAtStaticInit = Scan::skipWhitespace(gStaticInput, gStaticInput + sizeof(gStaticInput) - 1);
+
+}  // namespace
+
+TEST(ScanStaticInitTest, WorksBeforeMain) {
+    EXPECT_EQ(gSkippedAtStaticInit, gStaticInput + 4);
+}
+
+class ScanTest : public ::testing::TestWithParam<Scan::Isa> {
+   protected:
+    void SetUp() override {
+        mPreviousIsa = Scan::getIsa();
+        if (!Scan::setIsa(GetParam()))
+            GTEST_SKIP() << "Instruction set not supported on this CPU";
+    }
+
+    void TearDown() override {
+        Scan::setIsa(mPreviousIsa);
+    }
+
+    // Mostly whitespace, quotes and newlines so that every kernel stops at varying positions
+    static std::string randomBuffer(std::mt19937& rng, std::size_t size) {
+        static const char bytes[] = " \t\n\v\f\r\"\0a_9;/\x80\xff";
+        static const std::string alphabet(bytes, sizeof(bytes) - 1);
+        std::uniform_int_distribution<std::size_t> pick(0, alphabet.size() - 1);
+        std::uniform_int_distribution<int> runLength(0, 40);
+
+        std::string buffer;
+        while (buffer.size() < size) {
+            buffer.append(runLength(rng), alphabet[pick(rng) % 6]);
+            buffer += alphabet[pick(rng)];
+        }
+        buffer.resize(size);
+        return buffer;
+    }
+
+    Scan::Isa mPreviousIsa;
+};
+
+TEST_P(ScanTest, MatchesScalarReference) {
+    std::mt19937 rng(42);
+
+    for (int round = 0; round < 200; ++round) {
+        const std::string buffer = randomBuffer(rng, 1 + round * 3);
+        const char* end = buffer.data() + buffer.size();
+
+        for (const char* it = buffer.data(); it <= end; ++it) {
+            const char* space = it;
+            while (space != end and isspace(static_cast<unsigned char>(*space)))
+                ++space;
+            const char* newline = it;
+            while (newline != end and *newline != '\n')
+                ++newline;
+            const char* stringEnd = it;
+            while (stringEnd != end and *stringEnd != '\"' and *stringEnd != '\n' and *stringEnd != '\0')
+                ++stringEnd;
+            const char* nonAscii = it;
+            while (nonAscii != end and (unsigned char)*nonAscii < 0x80)
+                ++nonAscii;
+
+            ASSERT_EQ(Scan::skipWhitespace(it, end), space);
+            ASSERT_EQ(Scan::findNewline(it, end), newline);
+            ASSERT_EQ(Scan::findStringEnd(it, end), stringEnd);
+            ASSERT_EQ(Scan::findNonAscii(it, end), nonAscii);
+        }
+    }
+}
+
+TEST_P(ScanTest, LexerIsUnchanged) {
+    std::vector<std::pair<Lexer::Token, std::uint64_t>> received;
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init("source_code/full/sort.crst"));
+    for (Lexer::Token token = lexer.getNextTokenAndComment(); token != Lexer::Token::TOK_EOF; token = lexer.getNextTokenAndComment())
+        received.emplace_back(token, lexer.GetCurrentLocation().getOffset());
+
+    Scan::setIsa(Scan::Isa::SCALAR);
+
+    std::vector<std::pair<Lexer::Token, std::uint64_t>> expected;
+    ASSERT_TRUE(lexer.init("source_code/full/sort.crst"));
+    for (Lexer::Token token = lexer.getNextTokenAndComment(); token != Lexer::Token::TOK_EOF; token = lexer.getNextTokenAndComment())
+        expected.emplace_back(token, lexer.GetCurrentLocation().getOffset());
+
+    EXPECT_EQ(received, expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllInstructionSets, ScanTest,
+                         ::testing::Values(Scan::Isa::SCALAR, Scan::Isa::SSE2, Scan::Isa::AVX2));
+
+}  // namespace Crust
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <common/sourcebuffer.hpp>
+#include <fstream>
+#include <iterator>
+#include <parser/lexer.hpp>
+#include <string>
+
+namespace Crust {
+
+class SourceBufferTest : public ::testing::Test {
+   protected:
+    static std::string readWholeFile(const std::string& filename) {
+        std::ifstream stream(filename);
+        return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    static bool pointsInto(std::string_view inner, std::string_view outer) {
+        return inner.data() >= outer.data() and inner.data() + inner.size() <= outer.data() + outer.size();
+    }
+};
+
+TEST_F(SourceBufferTest, MapsRegularFiles) {
+    auto buffer = SourceBuffer::fromFile("source_code/full/sort.crst");
+
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_TRUE(buffer->isMapped());
+    EXPECT_EQ(buffer->getContents(), readWholeFile("source_code/full/sort.crst"));
+}
+
+TEST_F(SourceBufferTest, HandlesEmptyFiles) {
+    auto buffer = SourceBuffer::fromFile("source_code/basic/empty.crst");
+
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_EQ(buffer->getSize(), 0u);
+}
+
+TEST_F(SourceBufferTest, FailsOnMissingFiles) {
+    EXPECT_EQ(SourceBuffer::fromFile("source_code/does_not_exist.crst"), nullptr);
+
+    Lexer lexer;
+    EXPECT_FALSE(lexer.init("source_code/does_not_exist.crst"));
+}
+
+TEST_F(SourceBufferTest, ReadsPipes) {
+    const std::string source = "i32 x;\nfn main() void {}\n";
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    ASSERT_EQ(write(fds[1], source.data(), source.size()), (ssize_t)source.size());
+    close(fds[1]);
+
+    auto buffer = SourceBuffer::fromFileDescriptor(fds[0], "<pipe>");
+    close(fds[0]);
+
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_FALSE(buffer->isMapped());
+    EXPECT_EQ(buffer->getContents(), source);
+}
+
+TEST_F(SourceBufferTest, ResolvesLinesAndColumns) {
+    for (const std::string& source : {std::string(), std::string("\n\n"), std::string("a\nbc\n\nd"),
+                                     readWholeFile("source_code/full/sort.crst")}) {
+        auto buffer = SourceBuffer::fromString(source);
+
+        // Walk the buffer one byte at a time, the way locations used to be tracked
+        unsigned line = 1, column = 1;
+        for (std::size_t offset = 0; offset <= source.size(); ++offset) {
+            const LineColumn position = buffer->getLineColumn(SourceLocation(offset));
+            ASSERT_EQ(position.line, line) << "offset " << offset;
+            ASSERT_EQ(position.column, column) << "offset " << offset;
+
+            if (offset < source.size() and source[offset] == '\n') {
+                ++line;
+                column = 1;
+            } else {
+                ++column;
+            }
+        }
+        EXPECT_EQ(buffer->getLineCount(), line);
+    }
+}
+
+TEST_F(SourceBufferTest, LexerPayloadsPointIntoBuffer) {
+    auto buffer = SourceBuffer::fromFile("source_code/basic/literals.crst");
+    ASSERT_NE(buffer, nullptr);
+
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init(buffer));
+
+    Lexer::Token token;
+    while ((token = lexer.getNextToken()) != Lexer::Token::TOK_EOF) {
+        if (token == Lexer::Token::STR_LITERAL) {
+            EXPECT_TRUE(pointsInto(lexer.getCurrentStr(), buffer->getContents()));
+        }
+    }
+}
+
+TEST_F(SourceBufferTest, EditsIntoANewBuffer) {
+    const auto buffer = SourceBuffer::fromString("fn main() void {\n    x = 1;\n}\n", "main.crst");
+    const std::string_view before = buffer->getContents();
+
+    const auto edited = SourceBuffer::edit(*buffer, 21, 1, "yy");
+    EXPECT_EQ(buffer->getContents(), "fn main() void {\n    x = 1;\n}\n");
+    EXPECT_EQ(edited->getContents(), "fn main() void {\n    yy = 1;\n}\n");
+    EXPECT_FALSE(pointsInto(edited->getContents(), before));
+    EXPECT_EQ(edited->getName(), "main.crst");
+    EXPECT_EQ(edited->getLineColumn(SourceLocation(23)).line, 2u);
+    EXPECT_EQ(edited->getLineColumn(SourceLocation(23)).column, 7u);
+
+    const auto mapped = SourceBuffer::fromFile("source_code/full/sort.crst");
+    const auto fromMapped = SourceBuffer::edit(*mapped, 0, 0, "// sorted\n");
+    EXPECT_EQ(fromMapped->getContents(), "// sorted\n" + readWholeFile("source_code/full/sort.crst"));
+}
+
+}  // namespace Crust
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <common/errorlogger.hpp>
+#include <common/sourcebuffer.hpp>
+#include <common/sourcemanager.hpp>
+#include <fstream>
+#include <iterator>
+#include <parser/lexer.hpp>
+#include <string>
+#include <vector>
+
+namespace Crust {
+
+class SourceManagerTest : public ::testing::Test {
+   protected:
+    static std::string readWholeFile(const std::string& filename) {
+        std::ifstream stream(filename);
+        return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    // Expects every location of file to resolve back to it, at the position its own buffer gives
+    static void expectResolves(const SourceManager& sources, FileID file) {
+        const auto& buffer = sources.getBuffer(file);
+        const auto reference = SourceBuffer::fromString(std::string(buffer->getContents()));
+
+        for (std::uint64_t offset = 0; offset <= buffer->getSize(); ++offset) {
+            const GlobalLocation location = sources.getGlobalLocation(file, SourceLocation(offset));
+            ASSERT_EQ(sources.getFileID(location), file) << sources.getName(file) << " offset " << offset;
+            ASSERT_EQ(sources.getLocalLocation(location)->getOffset(), offset);
+
+            const LineColumn expected = reference->getLineColumn(SourceLocation(offset));
+            const LineColumn position = *sources.getLineColumn(location);
+            ASSERT_EQ(position.line, expected.line) << sources.getName(file) << " offset " << offset;
+            ASSERT_EQ(position.column, expected.column) << sources.getName(file) << " offset " << offset;
+        }
+    }
+};
+
+TEST_F(SourceManagerTest, LoadsFilesAndStrings) {
+    SourceManager sources;
+    const FileID sort = sources.addFile("source_code/full/sort.crst");
+    const FileID empty = sources.addFile("source_code/basic/empty.crst");
+    const FileID text = sources.addString("x = 1;\ny = 2;", "<text>");
+    const FileID fact = sources.addFile("source_code/full/fact.crst");
+
+    ASSERT_TRUE(sort.isValid() and empty.isValid() and text.isValid() and fact.isValid());
+    EXPECT_EQ(sources.getFileCount(), 4u);
+    EXPECT_EQ(sources.getBuffer(sort)->getContents(), readWholeFile("source_code/full/sort.crst"));
+    EXPECT_EQ(sources.getBuffer(empty)->getSize(), 0u);
+    EXPECT_EQ(sources.getBuffer(text)->getContents(), "x = 1;\ny = 2;");
+    EXPECT_EQ(sources.getBuffer(fact)->getContents(), readWholeFile("source_code/full/fact.crst"));
+    EXPECT_EQ(sources.getName(fact), "source_code/full/fact.crst");
+
+    EXPECT_FALSE(sources.addFile("source_code/does_not_exist.crst").isValid());
+    EXPECT_EQ(sources.getFileCount(), 4u);
+}
+
+TEST_F(SourceManagerTest, ResolvesGlobalLocations) {
+    SourceManager sources;
+    std::vector<FileID> files;
+    for (const char* filename : {"source_code/full/sort.crst", "source_code/basic/empty.crst", "source_code/full/swap.crst"})
+        files.push_back(sources.addFile(filename));
+    files.push_back(sources.addString("\n\nlast line", "<string>"));
+    files.push_back(sources.addString("", "<empty>"));
+
+    for (FileID file : files) expectResolves(sources, file);
+
+    EXPECT_FALSE(sources.getFileID(GlobalLocation()).isValid());
+    EXPECT_FALSE(sources.getFileID(GlobalLocation(0xfffffff0)).isValid());
+}
+
+// Past the range of the last file and invalid locations resolve to nothing instead of indexing out of bounds
+TEST_F(SourceManagerTest, LeavesLocationsOutsideFilesUnresolved) {
+    SourceManager sources;
+    const FileID file = sources.addString("let x = 1;\n");
+    const GlobalLocation end = sources.getGlobalLocation(file, SourceLocation(11));
+    ASSERT_TRUE(sources.getLineColumn(end).has_value());
+
+    for (GlobalLocation location : {GlobalLocation(), GlobalLocation(end.getOffset() + 0x100000)}) {
+        EXPECT_FALSE(sources.getFileID(location).isValid());
+        EXPECT_FALSE(sources.getLocalLocation(location).has_value());
+        EXPECT_FALSE(sources.getLineColumn(location).has_value());
+    }
+
+    SourceManager empty;
+    EXPECT_FALSE(empty.getLineColumn(GlobalLocation(0)).has_value());
+}
+
+TEST_F(SourceManagerTest, LaysFilesOutInOneArena) {
+    SourceManager sources;
+    if (!sources.hasArena())
+        GTEST_SKIP() << "no address space for the arena";
+
+    const FileID first = sources.addFile("source_code/full/sort.crst");
+    const FileID second = sources.addString("fn main() i32 { return 0; }");
+    const FileID third = sources.addFile("source_code/full/swap.crst");
+
+    // The bytes of every file sit at the same distance from each other as their locations
+    const char* base = sources.getBuffer(first)->getContents().data();
+    for (FileID file : {second, third}) {
+        const GlobalLocation location = sources.getGlobalLocation(file, SourceLocation(0));
+        EXPECT_EQ(sources.getBuffer(file)->getContents().data() - base, (std::ptrdiff_t)location.getOffset());
+    }
+}
+
+TEST_F(SourceManagerTest, ReadsFromPipes) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const std::string contents = "i32 x;\n";
+    ASSERT_EQ(write(fds[1], contents.data(), contents.size()), (ssize_t)contents.size());
+    close(fds[1]);
+
+    SourceManager sources;
+    sources.addString("i32 y;");
+    const FileID file = sources.addFileDescriptor(fds[0], "<pipe>");
+    close(fds[0]);
+
+    ASSERT_TRUE(file.isValid());
+    EXPECT_EQ(sources.getBuffer(file)->getContents(), contents);
+    expectResolves(sources, file);
+}
+
+TEST_F(SourceManagerTest, ReportsErrorsWithTheFileName) {
+    SourceManager sources;
+    sources.addString("i32 x;\n", "first.crst");
+    const FileID file = sources.addString("i32 y;\ni32 @;\n", "second.crst");
+
+    testing::internal::CaptureStderr();
+    ErrorLogger::printErrorAtLocation(ErrorLogger::ErrorType::INVALID_SYMBOL, sources, sources.getGlobalLocation(file, SourceLocation(11)));
+    EXPECT_EQ(testing::internal::GetCapturedStderr(), "ERROR: Invalid Symbol used in second.crst at line 2, column 5\n");
+}
+
+TEST_F(SourceManagerTest, KeepsBuffersAfterTheManager) {
+    std::shared_ptr<const SourceBuffer> buffer;
+    {
+        SourceManager sources;
+        buffer = sources.getBuffer(sources.addFile("source_code/full/sort.crst"));
+    }
+
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init(buffer));
+    Lexer reference;
+    ASSERT_TRUE(reference.init("source_code/full/sort.crst"));
+    for (;;) {
+        const Lexer::Token token = reference.getNextTokenAndComment();
+        ASSERT_EQ(lexer.getNextTokenAndComment(), token);
+        if (token == Lexer::Token::TOK_EOF)
+            break;
+    }
+}
+
+}  // namespace Crust
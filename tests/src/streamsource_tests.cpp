@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <common/sourcebuffer.hpp>
+#include <common/streamsource.hpp>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <parser/lexer.hpp>
+#include <parser/tokentable.hpp>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Crust {
+
+class StreamSourceTest : public ::testing::Test {
+   protected:
+    static std::string readWholeFile(const std::string& filename) {
+        std::ifstream stream(filename);
+        return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    // Lexes contents from a buffer and from a stream with the given window, and expects the same tokens
+    static void expectSameTokens(const std::string& contents, std::size_t capacity, Lexer::Backend backend) {
+        std::istringstream stream(contents);
+        Lexer buffered;
+        Lexer streamed;
+        ASSERT_TRUE(buffered.init(SourceBuffer::fromString(contents)));
+        ASSERT_TRUE(streamed.init(StreamSource::fromStream(stream, "<test>", capacity)));
+        buffered.setBackend(backend);
+        streamed.setBackend(backend);
+
+        for (std::size_t idx = 0;; ++idx) {
+            const Lexer::Token expected = buffered.getNextTokenAndComment();
+            ASSERT_EQ(streamed.getNextTokenAndComment(), expected) << "token " << idx;
+
+            ASSERT_EQ(streamed.getCurrentTokenOffset(), buffered.getCurrentTokenOffset()) << "token " << idx;
+            ASSERT_EQ(streamed.getCurrentTokenLength(), buffered.getCurrentTokenLength()) << "token " << idx;
+            ASSERT_EQ(streamed.GetCurrentLocation(), buffered.GetCurrentLocation()) << "token " << idx;
+
+            const LineColumn expectedPosition = buffered.getLineColumn(buffered.GetCurrentLocation());
+            const LineColumn position = streamed.getLineColumn(streamed.GetCurrentLocation());
+            ASSERT_EQ(position.line, expectedPosition.line) << "token " << idx;
+            ASSERT_EQ(position.column, expectedPosition.column) << "token " << idx;
+
+            if (expected == Lexer::Token::IDENTIFIER or expected == Lexer::Token::STR_LITERAL) {
+                ASSERT_EQ(streamed.getCurrentStr(), buffered.getCurrentStr()) << "token " << idx;
+                ASSERT_EQ(streamed.getCurrentSymbol(), buffered.getCurrentSymbol()) << "token " << idx;
+            } else if (expected == Lexer::Token::INT_LITERAL) {
+                ASSERT_EQ(streamed.getCurrentInt(), buffered.getCurrentInt()) << "token " << idx;
+            } else if (expected == Lexer::Token::FLOAT_LITERAL) {
+                ASSERT_EQ(streamed.getCurrentFloat(), buffered.getCurrentFloat()) << "token " << idx;
+            }
+
+            if (expected == Lexer::Token::TOK_EOF)
+                break;
+        }
+    }
+
+    static std::size_t countTokens(Lexer& lexer) {
+        std::size_t count = 0;
+        while (lexer.getNextTokenAndComment() != Lexer::Token::TOK_EOF) ++count;
+        return count;
+    }
+};
+
+TEST_F(StreamSourceTest, MatchesBufferOnSourceCode) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator("source_code"))
+        if (entry.path().extension() == ".crst")
+            files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+    ASSERT_FALSE(files.empty());
+
+    for (const auto& file : files) {
+        const std::string contents = readWholeFile(file.string());
+        for (std::size_t capacity : {1, 2, 3, 7, 64}) {
+            SCOPED_TRACE(file.string() + " capacity " + std::to_string(capacity));
+            expectSameTokens(contents, capacity, Lexer::Backend::HANDWRITTEN);
+            expectSameTokens(contents, capacity, Lexer::Backend::DFA);
+        }
+    }
+}
+
+TEST_F(StreamSourceTest, MatchesBufferOnMalformedTokens) {
+    for (const char* source : {"12abc = 4; x", "1.", "1.\n2", "1..5", "\"open", "\"line\nbreak\" y", "!= !x", "@#$ `",
+                               "caf\xc3\xa9 = 1", "a\xf0\x9d\x91\xa5" "b", "a\xc3", "\"\xc3(\" x"}) {
+        for (std::size_t capacity : {1, 2, 5}) {
+            SCOPED_TRACE(std::string(source) + " capacity " + std::to_string(capacity));
+            expectSameTokens(source, capacity, Lexer::Backend::HANDWRITTEN);
+            expectSameTokens(source, capacity, Lexer::Backend::DFA);
+        }
+    }
+}
+
+TEST_F(StreamSourceTest, KeepsWindowSizeOnLargeInputs) {
+    std::string contents;
+    for (int line = 0; contents.size() < (4u << 20); ++line)
+        contents += "let x" + std::to_string(line) + ": i32 = " + std::to_string(line % 1000) + "; // comment\n";
+
+    std::istringstream stream(contents);
+    auto source = StreamSource::fromStream(stream, "<large>", 4096);
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init(source));
+
+    Lexer reference;
+    ASSERT_TRUE(reference.init(SourceBuffer::fromString(contents)));
+
+    EXPECT_EQ(countTokens(lexer), countTokens(reference));
+    EXPECT_EQ(source->getCapacity(), 4096u);
+    EXPECT_EQ(lexer.GetCurrentLocation().getOffset(), contents.size());
+}
+
+TEST_F(StreamSourceTest, SkipsLongCommentsWithoutGrowing) {
+    const std::string contents = "a // " + std::string(100000, 'c') + "\nb";
+    std::istringstream stream(contents);
+    auto source = StreamSource::fromStream(stream, "<comment>", 256);
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init(source));
+
+    EXPECT_EQ(lexer.getNextTokenAndComment(), Lexer::Token::IDENTIFIER);
+    EXPECT_EQ(lexer.getNextTokenAndComment(), Lexer::Token::COMMENT);
+    EXPECT_EQ(lexer.getCurrentTokenOffset(), 2u);
+    EXPECT_EQ(lexer.getCurrentTokenLength(), contents.size() - 4);
+    EXPECT_EQ(lexer.getNextTokenAndComment(), Lexer::Token::IDENTIFIER);
+    EXPECT_EQ(lexer.getCurrentStr(), "b");
+    EXPECT_EQ(lexer.getLineColumn(lexer.GetCurrentLocation()).line, 2u);
+    EXPECT_EQ(source->getCapacity(), 256u);
+}
+
+// An error recovery drops what it skips window by window, like a comment, and reports the same error
+TEST_F(StreamSourceTest, SkipsErrorRecoveriesWithoutGrowing) {
+    const std::string filler(100000, 'x');
+    for (const std::string& contents : {"a = 12abc" + filler + "; b", "a = \"open\n" + filler + "\" b"}) {
+        SCOPED_TRACE(contents.substr(0, 12));
+        testing::internal::CaptureStderr();
+        expectSameTokens(contents, 256, Lexer::Backend::HANDWRITTEN);
+        // Once from the buffer, once from the stream
+        const std::string errors = testing::internal::GetCapturedStderr();
+        EXPECT_EQ(std::count(errors.begin(), errors.end(), '\n'), 2);
+        EXPECT_EQ(errors.substr(0, errors.size() / 2), errors.substr(errors.size() / 2));
+
+        std::istringstream stream(contents);
+        auto source = StreamSource::fromStream(stream, "<recovery>", 256);
+        Lexer lexer;
+        ASSERT_TRUE(lexer.init(source));
+        testing::internal::CaptureStderr();
+        EXPECT_EQ(countTokens(lexer), 4u);
+        testing::internal::GetCapturedStderr();
+        EXPECT_EQ(source->getCapacity(), 256u);
+    }
+}
+
+TEST_F(StreamSourceTest, GrowsForTokensLongerThanTheWindow) {
+    const std::string literal(10000, 's');
+    std::istringstream stream("x = \"" + literal + "\";");
+    auto source = StreamSource::fromStream(stream, "<string>", 256);
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init(source));
+
+    EXPECT_EQ(lexer.getNextTokenAndComment(), Lexer::Token::IDENTIFIER);
+    EXPECT_EQ(lexer.getNextTokenAndComment(), Lexer::Token::ASSIGN);
+    EXPECT_EQ(lexer.getNextTokenAndComment(), Lexer::Token::STR_LITERAL);
+    EXPECT_EQ(lexer.getCurrentStr(), literal);
+    EXPECT_EQ(lexer.getNextTokenAndComment(), Lexer::Token::SEMI_COLON);
+    EXPECT_EQ(lexer.getNextTokenAndComment(), Lexer::Token::TOK_EOF);
+    EXPECT_GE(source->getCapacity(), literal.size());
+}
+
+// Offsets past 4 GiB reach the token table unwrapped
+TEST_F(StreamSourceTest, LexesInputsOverFourGiB) {
+    constexpr std::uint64_t blank = (std::uint64_t{1} << 32) + 16;
+    std::uint64_t produced = 0;
+    auto source = std::make_shared<StreamSource>(
+        [&produced](char* buffer, std::size_t size) -> std::size_t {
+            const std::string_view tail = "x;";
+            std::size_t count = 0;
+            if (produced < blank) {
+                count = std::min<std::uint64_t>(size, blank - produced);
+                std::memset(buffer, ' ', count);
+            }
+            for (; count < size and produced + count < blank + tail.size(); ++count) buffer[count] = tail[produced + count - blank];
+            produced += count;
+            return count;
+        },
+        "<huge>");
+
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init(source));
+    const TokenTable tokens = lexer.lexAll();
+    ASSERT_EQ(tokens.size(), 3u);
+    EXPECT_EQ(tokens.getKind(0), Lexer::Token::IDENTIFIER);
+    EXPECT_EQ(tokens.getOffset(0), blank);
+    EXPECT_EQ(tokens.getOffset(1), blank + 1);
+    EXPECT_EQ(tokens.getOffset(2), blank + 2);
+    EXPECT_EQ(source->getCapacity(), StreamSource::DEFAULT_CAPACITY);
+}
+
+TEST_F(StreamSourceTest, ReadsFromPipes) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const std::string contents = readWholeFile("source_code/full/sort.crst");
+    ASSERT_EQ(write(fds[1], contents.data(), contents.size()), (ssize_t)contents.size());
+    close(fds[1]);
+
+    Lexer streamed;
+    ASSERT_TRUE(streamed.init(StreamSource::fromFileDescriptor(fds[0], "<pipe>", 16)));
+    Lexer buffered;
+    ASSERT_TRUE(buffered.init(SourceBuffer::fromString(contents)));
+
+    EXPECT_EQ(countTokens(streamed), countTokens(buffered));
+    EXPECT_EQ(streamed.getLineColumn(streamed.GetCurrentLocation()).line,
+              buffered.getLineColumn(buffered.GetCurrentLocation()).line);
+    close(fds[0]);
+}
+
+}  // namespace Crust
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <common/symbolpool.hpp>
+#include <parser/lexer.hpp>
+#include <parser/parser.hpp>
+#include <parser/tokentable.hpp>
+#include <string>
+#include <vector>
+
+namespace Crust {
+
+class SymbolPoolTest : public ::testing::Test {
+   protected:
+    SymbolPool mPool;
+};
+
+TEST_F(SymbolPoolTest, InternsEqualStringsOnce) {
+    const Symbol first = mPool.intern("count");
+    const Symbol other = mPool.intern("counter");
+
+    EXPECT_EQ(mPool.intern(std::string("count")), first);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(mPool.get(first), "count");
+    EXPECT_EQ(mPool.get(other), "counter");
+    EXPECT_EQ(mPool.size(), 2u);
+
+    EXPECT_EQ(mPool.get(mPool.intern("")), "");
+}
+
+TEST_F(SymbolPoolTest, ViewsSurviveGrowth) {
+    std::vector<Symbol> symbols;
+    std::vector<std::string_view> views;
+    for (int i = 0; i < 100000; ++i) {
+        symbols.push_back(mPool.intern("name_" + std::to_string(i)));
+        views.push_back(mPool.get(symbols.back()));
+    }
+    // Longer than an arena block
+    const Symbol huge = mPool.intern(std::string(200000, 'x'));
+
+    for (int i = 0; i < 100000; ++i) {
+        ASSERT_EQ(views[i], "name_" + std::to_string(i));
+        ASSERT_EQ(mPool.intern("name_" + std::to_string(i)), symbols[i]);
+    }
+    EXPECT_EQ(mPool.get(huge), std::string(200000, 'x'));
+    EXPECT_EQ(mPool.size(), 100001u);
+}
+
+TEST_F(SymbolPoolTest, LexerInternsIdentifiersAndStrings) {
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init(SourceBuffer::fromString("swap(x, \"x\", y, x)")));
+
+    std::vector<Symbol> symbols;
+    for (Lexer::Token token = lexer.getNextToken(); token != Lexer::Token::TOK_EOF; token = lexer.getNextToken())
+        if (token == Lexer::Token::IDENTIFIER or token == Lexer::Token::STR_LITERAL)
+            symbols.push_back(lexer.getCurrentSymbol());
+
+    ASSERT_EQ(symbols.size(), 5u);
+    EXPECT_EQ(SymbolPool::global().get(symbols[0]), "swap");
+    EXPECT_EQ(symbols[1], symbols[2]);
+    EXPECT_EQ(symbols[1], symbols[4]);
+    EXPECT_NE(symbols[1], symbols[3]);
+}
+
+TEST_F(SymbolPoolTest, TreeTokensCarrySymbols) {
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init(SourceBuffer::fromString("i32 total;")));
+    TokenTable tokens = lexer.lexAll();
+
+    ASSERT_EQ(tokens.getKind(1), Lexer::Token::IDENTIFIER);
+    EXPECT_EQ(tokens.getSymbol(1), SymbolPool::global().intern("total"));
+    EXPECT_EQ(tokens.getStr(1), "total");
+
+    Token node(Lexer::Token::IDENTIFIER, tokens.getSymbol(1));
+    EXPECT_EQ(node.getSymbol(), tokens.getSymbol(1));
+    EXPECT_EQ(node.getName(), "TOKEN_IDENTIFIER(total)");
+}
+
+// Names are returned by reference: built once for a symbol, shared by the tokens of a kind
+TEST_F(SymbolPoolTest, TreeTokenNamesAreNotCopied) {
+    const Token identifier(Lexer::Token::IDENTIFIER, SymbolPool::global().intern("count"));
+    EXPECT_EQ(identifier.getName(), "TOKEN_IDENTIFIER(count)");
+    EXPECT_EQ(&identifier.getName(), &identifier.getName());
+
+    const Token lparen(Lexer::Token::LPAREN);
+    EXPECT_EQ(lparen.getName(), "TOKEN_LPAREN");
+    EXPECT_EQ(&lparen.getName(), &Token(Lexer::Token::LPAREN).getName());
+
+    EXPECT_EQ(Token(Lexer::Token::INT_LITERAL, std::uint64_t{7}).getName(), "TOKEN_INT_LITERAL(7)");
+}
+
+}  // namespace Crust
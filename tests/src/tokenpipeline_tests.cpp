@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <common/corpusgenerator.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <parser/parser.hpp>
+#include <parser/tokenpipeline.hpp>
+#include <parser/tokenview.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// While set, allocations fail on every thread but the one that set it, as a producer running out of memory would
+std::atomic<bool> gFailOtherThreads{false};
+std::thread::id gAllowedThread;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    if (gFailOtherThreads.load() and std::this_thread::get_id() != gAllowedThread)
+        throw std::bad_alloc();
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace Crust {
+
+class TokenPipelineTest : public ::testing::Test {
+   protected:
+    static std::vector<std::filesystem::path> sourceFiles() {
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator("source_code"))
+            if (entry.path().extension() == ".crst")
+                files.push_back(entry.path());
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    // Reads source through the lexer and through a pipeline, and expects the same tokens and diagnostics
+    static void expectSameTokens(const std::shared_ptr<const SourceBuffer>& source, std::size_t batchSize, std::size_t batches) {
+        Lexer lexer;
+        ASSERT_TRUE(lexer.init(source));
+        testing::internal::CaptureStderr();
+        std::vector<LexedToken> expected;
+        for (const LexedToken& token : TokenView(lexer)) expected.push_back(token);
+        const std::string expectedErrors = testing::internal::GetCapturedStderr();
+
+        testing::internal::CaptureStderr();
+        std::vector<LexedToken> tokens;
+        {
+            TokenPipeline pipeline(source, batchSize, batches);
+            for (LexedToken token = pipeline.next(); token.kind != Lexer::Token::TOK_EOF; token = pipeline.next())
+                tokens.push_back(token);
+            EXPECT_EQ(pipeline.next().kind, Lexer::Token::TOK_EOF);
+        }
+        EXPECT_EQ(testing::internal::GetCapturedStderr(), expectedErrors);
+        EXPECT_EQ(tokens, expected);
+    }
+
+    // Printed tree and diagnostics of parsing filename
+    static std::pair<std::string, std::string> parse(const std::string& filename, bool pipelined) {
+        Parser parser;
+        parser.setPipelined(pipelined);
+        testing::internal::CaptureStderr();
+        const auto program = parser.parseProgram(filename);
+        std::string errors = testing::internal::GetCapturedStderr();
+
+        std::string tree;
+        describe(program.get(), tree);
+        return {tree, std::move(errors)};
+    }
+
+    // Names of the nodes in prefix order. Printing the tree is no good, as it leaves its indentation
+    // off after a missing child
+    static void describe(const CFGNode* node, std::string& out) {
+        if (!node) {
+            out += "null ";
+            return;
+        }
+        out += node->getName() + "( ";
+        for (const auto& child : node->getChildrenNodes()) describe(child.get(), out);
+        out += ") ";
+    }
+};
+
+TEST_F(TokenPipelineTest, MatchesLexerOnSourceCode) {
+    const auto files = sourceFiles();
+    ASSERT_FALSE(files.empty());
+
+    for (const auto& file : files) {
+        const auto source = SourceBuffer::fromFile(file.string());
+        for (std::size_t batchSize : {1, 3, 1024}) {
+            SCOPED_TRACE(file.string() + " batch size " + std::to_string(batchSize));
+            expectSameTokens(source, batchSize, 2);
+        }
+    }
+}
+
+TEST_F(TokenPipelineTest, MatchesLexerThroughAFullRing) {
+    const auto source = SourceBuffer::fromString(CorpusGenerator({CorpusGenerator::Shape::MIXED, 256 << 10, 4, 3}).generate());
+    expectSameTokens(source, 7, 2);
+    expectSameTokens(source, 64, 4);
+}
+
+TEST_F(TokenPipelineTest, StopsBeforeTheEnd) {
+    const auto source = SourceBuffer::fromString(CorpusGenerator({CorpusGenerator::Shape::FUNCTIONS, 1 << 20, 4, 5}).generate());
+    for (int round = 0; round < 20; ++round) {
+        TokenPipeline pipeline(source, 16, 2);
+        for (int idx = 0; idx < round * 7; ++idx) pipeline.next();
+    }
+}
+
+TEST_F(TokenPipelineTest, ParsesLikeTheSequentialParser) {
+    auto files = sourceFiles();
+    const std::string generated = (std::filesystem::temp_directory_path() / "crust_pipeline_test.crst").string();
+    {
+        std::ofstream out(generated);
+        CorpusGenerator({CorpusGenerator::Shape::MIXED, 64 << 10, 4, 11}).generate(out);
+    }
+    files.push_back(generated);
+
+    for (const auto& file : files) {
+        SCOPED_TRACE(file.string());
+        const auto expected = parse(file.string(), false);
+        const auto received = parse(file.string(), true);
+        EXPECT_EQ(received.first, expected.first);
+        EXPECT_EQ(received.second, expected.second);
+    }
+    std::filesystem::remove(generated);
+}
+
+// The producer throws when a diagnostic grows its batch, the tokens before it still come first
+TEST_F(TokenPipelineTest, RethrowsWhatTheProducerThrows) {
+    const auto source = SourceBuffer::fromString("let x = 1;\n@ y;\n");
+
+    gAllowedThread = std::this_thread::get_id();
+    gFailOtherThreads.store(true);
+    {
+        TokenPipeline pipeline(source, 1024, 2);
+        for (Lexer::Token kind : {Lexer::Token::KW_LET, Lexer::Token::IDENTIFIER, Lexer::Token::ASSIGN,
+                                  Lexer::Token::INT_LITERAL, Lexer::Token::SEMI_COLON})
+            EXPECT_EQ(pipeline.next().kind, kind);
+        EXPECT_THROW(pipeline.next(), std::bad_alloc);
+        gFailOtherThreads.store(false);
+
+        EXPECT_EQ(pipeline.next().kind, Lexer::Token::TOK_EOF);
+        EXPECT_EQ(pipeline.next().kind, Lexer::Token::TOK_EOF);
+    }
+    gFailOtherThreads.store(false);
+}
+
+}  // namespace Crust
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <parser/lexer.hpp>
+#include <parser/parser.hpp>
+#include <parser/tokentable.hpp>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Crust {
+
+class TokenTableTest : public ::testing::Test {
+   protected:
+    // Expects the same tokens and payloads as lexing source from scratch
+    static void expectSameAsLexAll(const TokenTable& tokens, const std::string& source, bool keepComments) {
+        Lexer lexer;
+        ASSERT_TRUE(lexer.init(SourceBuffer::fromString(source)));
+        const TokenTable expected = lexer.lexAll(keepComments);
+
+        ASSERT_EQ(tokens.getSource(), source);
+        ASSERT_EQ(tokens.size(), expected.size());
+        for (std::size_t idx = 0; idx < tokens.size(); ++idx) {
+            ASSERT_EQ(tokens.getKind(idx), expected.getKind(idx)) << "token " << idx;
+            ASSERT_EQ(tokens.getOffset(idx), expected.getOffset(idx)) << "token " << idx;
+            ASSERT_EQ(tokens.getLength(idx), expected.getLength(idx)) << "token " << idx;
+
+            if (expected.getKind(idx) == Lexer::Token::INT_LITERAL)
+                ASSERT_EQ(tokens.getInt(idx), expected.getInt(idx)) << "token " << idx;
+            else if (expected.getKind(idx) == Lexer::Token::FLOAT_LITERAL)
+                ASSERT_EQ(tokens.getFloat(idx), expected.getFloat(idx)) << "token " << idx;
+            else
+                ASSERT_EQ(tokens.getPayloadIndex(idx), expected.getPayloadIndex(idx)) << "token " << idx;
+        }
+    }
+
+    void useFile(const std::string& filename) {
+        ASSERT_TRUE(mLexer.init("source_code/" + filename));
+        ASSERT_TRUE(mReference.init("source_code/" + filename));
+        mTokens = mLexer.lexAll();
+    }
+
+    // Members
+    Lexer mLexer;
+    Lexer mReference;
+    TokenTable mTokens;
+};
+
+TEST_F(TokenTableTest, EndsWithEOF) {
+    useFile("basic/empty.crst");
+
+    ASSERT_EQ(mTokens.size(), 1u);
+    EXPECT_EQ(mTokens.getKind(0), Lexer::Token::TOK_EOF);
+}
+
+TEST_F(TokenTableTest, MatchesPullLexer) {
+    useFile("full/sort.crst");
+
+    for (std::size_t idx = 0; idx < mTokens.size(); ++idx) {
+        Lexer::Token expected = mReference.getNextToken();
+        ASSERT_EQ(mTokens.getKind(idx), expected) << "token " << idx;
+
+        EXPECT_EQ(mTokens.getOffset(idx), mReference.getCurrentTokenOffset());
+        EXPECT_EQ(mTokens.getLength(idx), mReference.getCurrentTokenLength());
+
+        if (expected == Lexer::Token::IDENTIFIER or expected == Lexer::Token::STR_LITERAL) {
+            EXPECT_EQ(mTokens.getStr(idx), mReference.getCurrentStr());
+        } else if (expected == Lexer::Token::INT_LITERAL) {
+            EXPECT_EQ(mTokens.getInt(idx), mReference.getCurrentInt());
+        } else {
+            EXPECT_EQ(mTokens.getPayloadIndex(idx), TokenTable::NO_PAYLOAD);
+        }
+
+        EXPECT_EQ(mTokens.getEndLocation(idx), mReference.GetCurrentLocation());
+    }
+}
+
+TEST_F(TokenTableTest, KeepsCommentsOnRequest) {
+    ASSERT_TRUE(mLexer.init("source_code/basic/comments.crst"));
+    mTokens = mLexer.lexAll(true);
+
+    ASSERT_EQ(mTokens.size(), 7u);
+    EXPECT_EQ(mTokens.getKind(0), Lexer::Token::COMMENT);
+    EXPECT_EQ(mTokens.getText(0), "// This is a Comment");
+}
+
+TEST_F(TokenTableTest, ParserProducesSameTree) {
+    useFile("parser/functions.crst");
+
+    Parser fromFile;
+    Parser fromTable;
+    auto expected = fromFile.parseProgram("source_code/parser/functions.crst");
+    auto received = fromTable.parseProgram(mTokens);
+
+    ASSERT_NE(expected, nullptr);
+    ASSERT_NE(received, nullptr);
+
+    std::ostringstream expectedStream, receivedStream;
+    expectedStream << *expected;
+    receivedStream << *received;
+    EXPECT_EQ(receivedStream.str(), expectedStream.str());
+}
+
+TEST_F(TokenTableTest, RelexesEdits) {
+    useFile("full/sort.crst");
+    std::string source(mTokens.getSource());
+
+    // Edits that merge, split and reopen tokens, from the start to the end of the buffer
+    const std::vector<Lexer::TextEdit> edits = {
+        {0, 0, "let y: f64 = 2.5;\n"}, {4, 1, "zz"},      {20, 3, ""},    {30, 0, "\"open\n"},
+        {31, 1, ""},                     {60, 0, "12 "}, {61, 0, "x"}, {100, 0, "// "},
+        {source.size() / 2, 10, "1."},   {0, 0, ""},     {40, 0, "= ="},
+    };
+
+    for (bool keepComments : {false, true}) {
+        ASSERT_TRUE(mLexer.init(SourceBuffer::fromString(source)));
+        mTokens = mLexer.lexAll(keepComments);
+        std::string edited = source;
+
+        for (const auto& edit : edits) {
+            SCOPED_TRACE(std::to_string(edit.offset) + " " + std::string(edit.text));
+            ASSERT_TRUE(mLexer.relex(mTokens, edit, keepComments));
+            edited.replace(edit.offset, edit.length, edit.text);
+            expectSameAsLexAll(mTokens, edited, keepComments);
+        }
+
+        const std::size_t end = edited.size();
+        ASSERT_TRUE(mLexer.relex(mTokens, {end, 0, " 42"}, keepComments));
+        expectSameAsLexAll(mTokens, edited + " 42", keepComments);
+        EXPECT_FALSE(mLexer.relex(mTokens, {end + 10, 0, "x"}, keepComments));
+    }
+}
+
+TEST_F(TokenTableTest, RelexesRandomEdits) {
+    static const char bytes[] = "ab_z09 \n\".:;{}=+/<!#";
+    std::mt19937 rng(13);
+
+    std::string source = "let x: i32 = 4;\nfn f() -> f32 { return 1.5 + x; } // done\n";
+    ASSERT_TRUE(mLexer.init(SourceBuffer::fromString(source)));
+    mTokens = mLexer.lexAll(true);
+
+    for (int round = 0; round < 500; ++round) {
+        const std::size_t offset = rng() % (source.size() + 1);
+        const std::size_t length = std::min<std::size_t>(rng() % 4, source.size() - offset);
+        std::string text(rng() % 4, ' ');
+        for (char& c : text) c = bytes[rng() % (sizeof(bytes) - 1)];
+
+        SCOPED_TRACE(source);
+        ASSERT_TRUE(mLexer.relex(mTokens, {offset, length, text}, true));
+        source.replace(offset, length, text);
+        expectSameAsLexAll(mTokens, source, true);
+    }
+}
+
+// Edits that keep replacing, adding and dropping literals reuse the payload slots of the ones they replace
+TEST_F(TokenTableTest, ReusesNumberSlotsAcrossEdits) {
+    std::string source = "let a: i32 = 1;\nlet b: f64 = 2.5;\nlet c: i32 = 3;\n";
+    ASSERT_TRUE(mLexer.init(SourceBuffer::fromString(source)));
+    mTokens = mLexer.lexAll();
+
+    const std::vector<Lexer::TextEdit> edits = {{13, 1, "7 8 9.5"}, {13, 7, "1"}, {29, 3, "4"}, {29, 1, "2.5"}};
+    std::size_t peakInts = 0, peakFloats = 0;
+    for (int round = 0; round < 10000; ++round) {
+        const Lexer::TextEdit& edit = edits[round % edits.size()];
+        ASSERT_TRUE(mLexer.relex(mTokens, edit));
+        source.replace(edit.offset, edit.length, edit.text);
+
+        std::size_t ints = 0, floats = 0;
+        for (std::size_t idx = 0; idx < mTokens.size(); ++idx) {
+            ints += mTokens.getKind(idx) == Lexer::Token::INT_LITERAL;
+            floats += mTokens.getKind(idx) == Lexer::Token::FLOAT_LITERAL;
+        }
+        peakInts = std::max(peakInts, ints);
+        peakFloats = std::max(peakFloats, floats);
+
+        for (std::size_t idx = 0; idx < mTokens.size(); ++idx) {
+            if (mTokens.getKind(idx) == Lexer::Token::INT_LITERAL) {
+                ASSERT_LT(mTokens.getPayloadIndex(idx), peakInts) << "round " << round;
+            } else if (mTokens.getKind(idx) == Lexer::Token::FLOAT_LITERAL) {
+                ASSERT_LT(mTokens.getPayloadIndex(idx), peakFloats) << "round " << round;
+            }
+        }
+        if (round % 997 == 0)
+            expectSameAsLexAll(mTokens, source, false);
+    }
+    expectSameAsLexAll(mTokens, source, false);
+}
+
+}  // namespace Crust
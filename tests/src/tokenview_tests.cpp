@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <parser/lexer.hpp>
+#include <parser/tokentable.hpp>
+#include <parser/tokenview.hpp>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+namespace Crust {
+
+static_assert(std::ranges::view<TokenView> and std::ranges::input_range<TokenView>);
+static_assert(std::ranges::view<Generator<LexedToken>> and std::ranges::input_range<Generator<LexedToken>>);
+
+class TokenViewTest : public ::testing::Test {
+   protected:
+    // Tokens of lexAll as values, without TOK_EOF
+    static std::vector<LexedToken> expectedTokens(const std::string& filename, bool keepComments) {
+        Lexer lexer;
+        lexer.init(filename);
+        const TokenTable table = lexer.lexAll(keepComments);
+
+        std::vector<LexedToken> tokens;
+        for (std::size_t idx = 0; idx + 1 < table.size(); ++idx) {
+            LexedToken token{table.getKind(idx), table.getOffset(idx), table.getLength(idx), {}};
+            if (token.kind == Lexer::Token::INT_LITERAL)
+                token.payload = table.getInt(idx);
+            else if (token.kind == Lexer::Token::FLOAT_LITERAL)
+                token.payload = table.getFloat(idx);
+            else if (token.kind == Lexer::Token::IDENTIFIER or token.kind == Lexer::Token::STR_LITERAL)
+                token.payload = table.getSymbol(idx);
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+
+    template <typename Range>
+    static std::vector<LexedToken> collect(Range&& range) {
+        std::vector<LexedToken> tokens;
+        for (const LexedToken& token : range) tokens.push_back(token);
+        return tokens;
+    }
+};
+
+TEST_F(TokenViewTest, MatchesLexAll) {
+    for (bool keepComments : {false, true}) {
+        const auto expected = expectedTokens("source_code/full/sort.crst", keepComments);
+        ASSERT_FALSE(expected.empty());
+
+        Lexer lexer;
+        lexer.init("source_code/full/sort.crst");
+        EXPECT_EQ(collect(TokenView(lexer, keepComments)), expected);
+
+        lexer.init("source_code/full/sort.crst");
+        EXPECT_EQ(collect(generateTokens(lexer, keepComments)), expected);
+    }
+}
+
+TEST_F(TokenViewTest, ComposesWithAdaptors) {
+    const auto isIdentifier = [](const LexedToken& token) { return token.kind == Lexer::Token::IDENTIFIER; };
+    const auto toStr = [](const LexedToken& token) { return token.getStr(); };
+
+    std::vector<std::string_view> expected;
+    for (const LexedToken& token : expectedTokens("source_code/full/sort.crst", false) | std::views::filter(isIdentifier))
+        expected.push_back(token.getStr());
+
+    Lexer lexer;
+    lexer.init("source_code/full/sort.crst");
+    std::vector<std::string_view> received;
+    std::ranges::copy(TokenView(lexer) | std::views::filter(isIdentifier) | std::views::transform(toStr), std::back_inserter(received));
+    EXPECT_EQ(received, expected);
+
+    lexer.init("source_code/full/sort.crst");
+    received.clear();
+    std::ranges::copy(generateTokens(lexer) | std::views::filter(isIdentifier) | std::views::transform(toStr), std::back_inserter(received));
+    EXPECT_EQ(received, expected);
+}
+
+TEST_F(TokenViewTest, LexesOnlyWhatIsRead) {
+    const auto expected = expectedTokens("source_code/full/sort.crst", false);
+
+    Lexer lexer;
+    lexer.init("source_code/full/sort.crst");
+    TokenView view(lexer);
+    auto it = view.begin();
+    ++it;
+    ++it;
+    EXPECT_EQ(*it, expected[2]);
+    EXPECT_EQ(lexer.GetCurrentLocation().getOffset(), expected[2].offset + expected[2].length);
+
+    lexer.init("source_code/full/sort.crst");
+    Generator<LexedToken> generator = generateTokens(lexer);
+    auto generated = generator.begin();
+    ++generated;
+    ++generated;
+    EXPECT_EQ(*generated, expected[2]);
+    EXPECT_EQ(lexer.GetCurrentLocation().getOffset(), expected[2].offset + expected[2].length);
+}
+
+TEST_F(TokenViewTest, EndsOnEmptySource) {
+    Lexer lexer;
+    lexer.init(SourceBuffer::fromString("  // comment\n"));
+    EXPECT_TRUE(collect(TokenView(lexer)).empty());
+
+    lexer.init(SourceBuffer::fromString("  // comment\n"));
+    EXPECT_EQ(collect(generateTokens(lexer, true)).size(), 1u);
+}
+
+TEST_F(TokenViewTest, GeneratorPropagatesExceptions) {
+    auto throwing = []() -> Generator<int> {
+        co_yield 1;
+        throw std::runtime_error("stop");
+    };
+
+    Generator<int> generator = throwing();
+    auto it = generator.begin();
+    EXPECT_EQ(*it, 1);
+    EXPECT_THROW(++it, std::runtime_error);
+}
+
+}  // namespace Crust
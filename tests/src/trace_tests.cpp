@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <parser/lexer.hpp>
+#include <parser/parser.hpp>
+#include <parser/tokentable.hpp>
+#include <parser/trace.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Crust {
+
+class TraceTest : public ::testing::Test {};
+
+TEST_F(TraceTest, KeepsTheLastRecords) {
+    Trace trace(3);
+    EXPECT_EQ(trace.getCapacity(), 4u);
+
+    for (std::uint64_t offset = 0; offset < 6; ++offset) trace.token(Lexer::Token::IDENTIFIER, offset, 1);
+    EXPECT_EQ(trace.size(), 4u);
+    EXPECT_EQ(trace.getDropped(), 2u);
+
+    const std::vector<Trace::Record> records = trace.getRecords();
+    ASSERT_EQ(records.size(), 4u);
+    for (std::size_t idx = 0; idx < records.size(); ++idx) EXPECT_EQ(records[idx].offset, idx + 2);
+
+    trace.clear();
+    EXPECT_EQ(trace.size(), 0u);
+    EXPECT_TRUE(trace.getRecords().empty());
+}
+
+TEST_F(TraceTest, PrintsRulesByDepth) {
+    Trace trace(16);
+    trace.enterRule(CFGNode::NodeKind::DECL, 0);
+    trace.token(Lexer::Token::KW_INT_32, 0, 3);
+    trace.enterRule(CFGNode::NodeKind::TYPE, 3);
+    trace.exitRule(CFGNode::NodeKind::TYPE, 5);
+    trace.exitRule(CFGNode::NodeKind::DECL, 6);
+
+    const std::vector<Trace::Record> records = trace.getRecords();
+    ASSERT_EQ(records.size(), 5u);
+    EXPECT_EQ(records[0].depth, 0);
+    EXPECT_EQ(records[1].depth, 1);
+    EXPECT_EQ(records[3].depth, 1);
+    EXPECT_EQ(records[4].depth, 0);
+    EXPECT_EQ(records[4].event, Trace::Event::EXIT_RULE);
+
+    std::ostringstream stream;
+    trace.print(stream);
+    EXPECT_EQ(stream.str(),
+              "> DECL @0\n"
+              "  KW_INT_32 @0+3\n"
+              "  > TYPE @3\n"
+              "  < TYPE @5\n"
+              "< DECL @6\n");
+}
+
+TEST_F(TraceTest, DumpsRecordsAsInMemory) {
+    Trace trace(2);
+    for (std::uint64_t offset = 0; offset < 3; ++offset) trace.token(Lexer::Token::SEMI_COLON, offset, 1);
+
+    std::ostringstream stream;
+    trace.dump(stream);
+    const std::string bytes = stream.str();
+    const std::vector<Trace::Record> records = trace.getRecords();
+    ASSERT_EQ(bytes.size(), records.size() * sizeof(Trace::Record));
+    EXPECT_EQ(bytes, std::string(reinterpret_cast<const char*>(records.data()), bytes.size()));
+}
+
+TEST_F(TraceTest, RecordsTheLexerAndTheParser) {
+    if constexpr (!Trace::enabled)
+        GTEST_SKIP() << "built without CRUST_TRACE";
+
+    Trace::local().clear();
+    Parser parser;
+    ASSERT_NE(parser.parseProgram("source_code/parser/functions.crst"), nullptr);
+    const std::vector<Trace::Record> records = Trace::local().getRecords();
+    Trace::local().clear();
+
+    ASSERT_FALSE(records.empty());
+    EXPECT_EQ(records.back().event, Trace::Event::EXIT_RULE);
+    EXPECT_EQ(records.back().id, (std::uint16_t)CFGNode::NodeKind::PROG_DECL);
+    EXPECT_EQ(std::count_if(records.begin(), records.end(), [](const auto& record) { return record.event == Trace::Event::ENTER_RULE; }),
+              std::count_if(records.begin(), records.end(), [](const auto& record) { return record.event == Trace::Event::EXIT_RULE; }));
+
+    Lexer lexer;
+    ASSERT_TRUE(lexer.init("source_code/parser/functions.crst"));
+    const TokenTable tokens = lexer.lexAll();
+    auto lexed = std::count_if(records.begin(), records.end(), [](const auto& record) {
+        return record.event == Trace::Event::TOKEN and record.id != (std::uint16_t)Lexer::Token::TOK_EOF;
+    });
+    EXPECT_EQ(lexed + 1, (std::ptrdiff_t)tokens.size());
+}
+
+}  // namespace Crust
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <parser/lexer.hpp>
+#include <parser/unicode.hpp>
+#include <string>
+
+namespace Crust {
+
+class UnicodeTest : public ::testing::Test {
+   protected:
+    static Unicode::Decoded decode(const std::string& bytes) {
+        return Unicode::decode(bytes.data(), bytes.data() + bytes.size());
+    }
+
+    static std::size_t validPrefix(const std::string& bytes) {
+        return Unicode::validate(bytes.data(), bytes.data() + bytes.size()) - bytes.data();
+    }
+};
+
+TEST_F(UnicodeTest, DecodesEveryLength) {
+    for (const auto& [bytes, codePoint] : {std::pair<std::string, char32_t>{"a", U'a'}, {"\xc3\xa9", U'é'},
+                                           {"\xe2\x82\xac", U'€'}, {"\xf0\x9f\x99\x82", U'\U0001f642'},
+                                           {"\xef\xbf\xbf", U'￿'}, {"\xf4\x8f\xbf\xbf", U'\U0010ffff'}}) {
+        const Unicode::Decoded decoded = decode(bytes);
+        EXPECT_TRUE(decoded.valid) << bytes;
+        EXPECT_EQ(decoded.codePoint, codePoint) << bytes;
+        EXPECT_EQ(decoded.length, bytes.size()) << bytes;
+    }
+}
+
+TEST_F(UnicodeTest, RejectsMalformedSequences) {
+    // Length of the longest valid prefix of each
+    for (const auto& [bytes, length] : {std::pair<std::string, unsigned>{"\x80", 1}, {"\xbf", 1}, {"\xc0\xaf", 1},
+                                        {"\xc1\xbf", 1}, {"\xe0\x80\xaf", 1}, {"\xed\xa0\x80", 1}, {"\xf0\x80\x80\xaf", 1},
+                                        {"\xf4\x90\x80\x80", 1}, {"\xf5\x80\x80\x80", 1}, {"\xff", 1}, {"\xc3", 1},
+                                        {"\xc3(", 1}, {"\xe2\x82", 2}, {"\xe2\x82(", 2}, {"\xf0\x9f\x99", 3}}) {
+        const Unicode::Decoded decoded = decode(bytes);
+        EXPECT_FALSE(decoded.valid) << bytes;
+        EXPECT_EQ(decoded.length, length) << bytes;
+    }
+}
+
+TEST_F(UnicodeTest, ValidatesPastAsciiBlocks) {
+    const std::string ascii(100, 'a');
+    EXPECT_EQ(validPrefix(ascii), ascii.size());
+    EXPECT_EQ(validPrefix(ascii + "\xc3\xa9" + ascii), 2 * ascii.size() + 2);
+    EXPECT_EQ(validPrefix(ascii + "\xc3\xa9\xc3" + ascii), ascii.size() + 2);
+    EXPECT_EQ(validPrefix(ascii + "\xed\xbf\xbf"), ascii.size());
+    EXPECT_EQ(validPrefix(""), 0u);
+}
+
+TEST_F(UnicodeTest, ClassifiesIdentifiers) {
+    for (char32_t codePoint : {U'a', U'Z', U'é', U'π', U'变', U'\U0001d465', U'\U00030000'})
+        EXPECT_TRUE(Unicode::isXidStart(codePoint)) << (unsigned)codePoint;
+    for (char32_t codePoint : {U'_', U'0', U' ', U'·', U'́', U'€', U'₁', U'\U0001f642'})
+        EXPECT_FALSE(Unicode::isXidStart(codePoint)) << (unsigned)codePoint;
+
+    for (char32_t codePoint : {U'_', U'0', U'·', U'́', U'٠'})
+        EXPECT_TRUE(Unicode::isXidContinue(codePoint)) << (unsigned)codePoint;
+    for (char32_t codePoint : {U'-', U'€', U'₁', U'\U0001f642'})
+        EXPECT_FALSE(Unicode::isXidContinue(codePoint)) << (unsigned)codePoint;
+}
+
+TEST_F(UnicodeTest, ClassifiesAsciiAtCompileTime) {
+    static_assert(Unicode::isIdentifierStart('_') and Unicode::isIdentifierStart('q') and !Unicode::isIdentifierStart('7'));
+    static_assert(Unicode::isIdentifierContinue('7') and !Unicode::isIdentifierContinue('-'));
+    static_assert(Unicode::isDigit('0') and !Unicode::isDigit('a'));
+    static_assert(!Unicode::isLetter('\xc3') and !Unicode::isIdentifierStart('\xc3'));
+}
+
+class UnicodeLexerTest : public ::testing::Test {
+   protected:
+    void useFile(const std::string& filename) {
+        ASSERT_TRUE(mLexer.init("source_code/" + filename));
+        mLexer.setBackend(Lexer::Backend::HANDWRITTEN);
+    }
+
+    void checkToken(Lexer::Token expectedToken) { EXPECT_EQ(mLexer.getNextToken(), expectedToken); }
+
+    void checkIdentifier(const std::string& expectedIdentifier) {
+        checkToken(Lexer::Token::IDENTIFIER);
+        EXPECT_EQ(mLexer.getCurrentStr(), expectedIdentifier);
+    }
+
+    void checkStringLiteral(const std::string& expectedLiteral) {
+        checkToken(Lexer::Token::STR_LITERAL);
+        EXPECT_EQ(mLexer.getCurrentStr(), expectedLiteral);
+    }
+
+    Lexer mLexer;
+};
+
+TEST_F(UnicodeLexerTest, ReturnsUnicodeIdentifiersAndStrings) {
+    useFile("basic/unicode.crst");
+    testing::internal::CaptureStderr();
+
+    checkIdentifier("caf\u00e9");
+    checkIdentifier("na\u00efve_1");
+    checkIdentifier("\u03c0");
+    checkIdentifier("\u03bbx");
+    checkIdentifier("_\u00fc");
+    checkIdentifier("\u53d8\u91cf");
+    checkIdentifier("\U0001d4651");
+
+    checkStringLiteral("h\u00e9llo w\u00f6rld");
+    checkStringLiteral("\u65e5\u672c\u8a9e \U0001f642");
+
+    checkToken(Lexer::Token::TOK_EOF);
+    EXPECT_EQ(testing::internal::GetCapturedStderr(), "");
+}
+
+// Each malformed sequence is one UNKNOWN token and one error, and lexing carries on after it
+TEST_F(UnicodeLexerTest, CausesUtf8Error) {
+    useFile("errors/utf8.crst");
+    testing::internal::CaptureStderr();
+
+    checkIdentifier("x");
+    checkToken(Lexer::Token::UNKNOWN);  // Not a lead byte
+    checkIdentifier("y");
+
+    checkToken(Lexer::Token::UNKNOWN);  // Overlong lead byte
+    checkToken(Lexer::Token::UNKNOWN);  // Lone continuation byte
+
+    checkToken(Lexer::Token::UNKNOWN);  // Surrogate, stops after the lead byte
+    checkToken(Lexer::Token::UNKNOWN);
+    checkToken(Lexer::Token::UNKNOWN);
+
+    checkToken(Lexer::Token::UNKNOWN);  // Valid, but not an identifier start
+    checkToken(Lexer::Token::ASSIGN);
+    checkToken(Lexer::Token::INT_LITERAL);
+    EXPECT_EQ(mLexer.getCurrentInt(), 1u);
+    checkToken(Lexer::Token::SEMI_COLON);
+
+    checkToken(Lexer::Token::UNKNOWN);  // Truncated sequence in a string literal
+    checkIdentifier("z");
+
+    checkIdentifier("a");
+    checkToken(Lexer::Token::UNKNOWN);  // Truncated by the end of the file
+
+    checkToken(Lexer::Token::TOK_EOF);
+    EXPECT_EQ(testing::internal::GetCapturedStderr(),
+              "ERROR: Invalid UTF-8 sequence at line 1, column 3\n"
+              "ERROR: Invalid UTF-8 sequence at line 2, column 2\n"
+              "ERROR: Invalid UTF-8 sequence at line 2, column 3\n"
+              "ERROR: Invalid UTF-8 sequence at line 3, column 2\n"
+              "ERROR: Invalid UTF-8 sequence at line 3, column 3\n"
+              "ERROR: Invalid UTF-8 sequence at line 3, column 4\n"
+              "ERROR: Invalid Symbol used at line 4, column 4\n"
+              "ERROR: Invalid UTF-8 sequence at line 5, column 4\n"
+              "ERROR: Invalid UTF-8 sequence at line 6, column 3\n");
+}
+
+}  // namespace Crust
@@ -0,0 +1,110 @@
+/*
+ * crustgen: writes synthetic Crust programs for benchmarks and stress tests
+ *
+ * Usage: crustgen [--shape <shape>] [--size <bytes>[k|m|g]] [--depth <n>] [--seed <n>] [--output <file>]
+ *
+ * The program is written to the output file, or to stdout, and only depends on the options. See
+ * common/corpusgenerator.hpp for the shapes and what the depth means for each of them.
+ */
+
+#include <charconv>
+#include <common/corpusgenerator.hpp>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+using namespace Crust;
+
+namespace {
+
+void printUsage(const char* name) {
+    std::cerr << "Usage: " << name << " [--shape <shape>] [--size <bytes>[k|m|g]] [--depth <n>] [--seed <n>] [--output <file>]\n"
+              << "Shapes: functions, conditionals, declarations, expressions, nesting, mixed (default)\n";
+}
+
+std::optional<std::uint64_t> parseNumber(std::string_view text, bool allowSuffix) {
+    std::uint64_t value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() or end == text.data())
+        return std::nullopt;
+
+    const std::string_view suffix(end, text.data() + text.size() - end);
+    if (suffix.empty())
+        return value;
+    if (!allowSuffix or suffix.size() != 1)
+        return std::nullopt;
+
+    switch (suffix[0]) {
+        case 'g':
+        case 'G':
+            return value << 30;
+        case 'm':
+        case 'M':
+            return value << 20;
+        case 'k':
+        case 'K':
+            return value << 10;
+        default:
+            return std::nullopt;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    CorpusGenerator::Options options;
+    std::string output;
+
+    for (int idx = 1; idx < argc; ++idx) {
+        const std::string_view option = argv[idx];
+        if (idx + 1 == argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const std::string_view value = argv[++idx];
+
+        std::optional<std::uint64_t> number;
+        if (option == "--shape") {
+            const auto shape = CorpusGenerator::parseShape(value);
+            if (!shape) {
+                std::cerr << "crustgen: unknown shape " << value << "\n";
+                return 1;
+            }
+            options.shape = *shape;
+            continue;
+        } else if (option == "--output") {
+            output = value;
+            continue;
+        } else if (option == "--size" and (number = parseNumber(value, true))) {
+            options.size = *number;
+        } else if (option == "--depth" and (number = parseNumber(value, false)) and *number <= 1u << 20) {
+            options.depth = *number;
+        } else if (option == "--seed" and (number = parseNumber(value, false))) {
+            options.seed = *number;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output, std::ios::binary);
+        if (!file) {
+            std::cerr << "crustgen: cannot open " << output << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+
+    CorpusGenerator(options).generate(out);
+    out.flush();
+    if (!out) {
+        std::cerr << "crustgen: cannot write " << (output.empty() ? "<stdout>" : output) << "\n";
+        return 1;
+    }
+    return 0;
+}
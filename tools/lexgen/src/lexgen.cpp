@@ -0,0 +1,475 @@
+/*
+ * lexgen: builds the lexer DFA from spec/tokens.g
+ *
+ * Usage: lexgen <tokens.g> <output header>
+ *
+ * Every regular expression rule of the specification is compiled into an NFA, the NFAs are joined
+ * under a single start state, turned into a DFA by subset construction over byte classes and
+ * minimized. The header written holds the byte class map, the dense transition table and the token
+ * accepted in every state, see lib/src/parser/dfalexer.cpp for the matching loop.
+ */
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using ByteSet = std::bitset<256>;
+
+struct Rule {
+    std::string name;
+    std::string pattern;
+    unsigned line;
+};
+
+struct NfaState {
+    std::vector<int> epsilon;
+    ByteSet bytes;
+    int next = -1;  /*!< Target of the byte edge, if bytes is not empty */
+    int rule = -1;  /*!< Index of the rule accepted here, or -1 */
+};
+
+struct Fragment {
+    int start;
+    int end;
+};
+
+/*
+ * \class RegexCompiler
+ * \brief Thompson construction of the patterns described in spec/tokens.g
+ */
+class RegexCompiler {
+   public:
+    explicit RegexCompiler(std::vector<NfaState>& states) : mStates{states} {}
+
+    Fragment compile(const std::string& pattern) {
+        mPattern = pattern;
+        mPos = 0;
+        Fragment fragment = parseAlternation();
+        if (mPos != mPattern.size())
+            fail("unexpected '" + std::string(1, mPattern[mPos]) + "'");
+        return fragment;
+    }
+
+   private:
+    int newState() {
+        mStates.emplace_back();
+        return mStates.size() - 1;
+    }
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error(message + " at offset " + std::to_string(mPos) + " of '" + mPattern + "'");
+    }
+
+    bool atEnd() const { return mPos == mPattern.size(); }
+
+    Fragment parseAlternation() {
+        Fragment fragment = parseConcatenation();
+        if (atEnd() or mPattern[mPos] != '|')
+            return fragment;
+
+        const int start = newState();
+        const int end = newState();
+        mStates[start].epsilon.push_back(fragment.start);
+        mStates[fragment.end].epsilon.push_back(end);
+        while (!atEnd() and mPattern[mPos] == '|') {
+            ++mPos;
+            Fragment alternative = parseConcatenation();
+            mStates[start].epsilon.push_back(alternative.start);
+            mStates[alternative.end].epsilon.push_back(end);
+        }
+        return {start, end};
+    }
+
+    Fragment parseConcatenation() {
+        const int start = newState();
+        Fragment fragment{start, start};
+        while (!atEnd() and mPattern[mPos] != '|' and mPattern[mPos] != ')') {
+            Fragment next = parseRepetition();
+            mStates[fragment.end].epsilon.push_back(next.start);
+            fragment.end = next.end;
+        }
+        return fragment;
+    }
+
+    Fragment parseRepetition() {
+        Fragment fragment = parseAtom();
+        while (!atEnd() and (mPattern[mPos] == '*' or mPattern[mPos] == '+' or mPattern[mPos] == '?')) {
+            const char op = mPattern[mPos++];
+            const int start = newState();
+            const int end = newState();
+            mStates[start].epsilon.push_back(fragment.start);
+            mStates[fragment.end].epsilon.push_back(end);
+            if (op != '+')
+                mStates[start].epsilon.push_back(end);
+            if (op != '?')
+                mStates[fragment.end].epsilon.push_back(fragment.start);
+            fragment = {start, end};
+        }
+        return fragment;
+    }
+
+    Fragment parseAtom() {
+        ByteSet bytes;
+        const char c = mPattern[mPos++];
+        switch (c) {
+            case '(': {
+                Fragment fragment = parseAlternation();
+                if (atEnd() or mPattern[mPos] != ')')
+                    fail("missing ')'");
+                ++mPos;
+                return fragment;
+            }
+            case '[':
+                bytes = parseClass();
+                break;
+            case '.':
+                bytes.set();
+                bytes.reset('\n');
+                break;
+            case '\\':
+                bytes.set(parseEscape());
+                break;
+            case '*':
+            case '+':
+            case '?':
+                fail("nothing to repeat");
+            default:
+                bytes.set((unsigned char)c);
+                break;
+        }
+
+        const int start = newState();
+        const int end = newState();
+        mStates[start].bytes = bytes;
+        mStates[start].next = end;
+        return {start, end};
+    }
+
+    ByteSet parseClass() {
+        ByteSet bytes;
+        const bool negated = !atEnd() and mPattern[mPos] == '^';
+        if (negated)
+            ++mPos;
+
+        while (!atEnd() and mPattern[mPos] != ']') {
+            const unsigned char first = parseClassByte();
+            unsigned char last = first;
+            if (mPos + 1 < mPattern.size() and mPattern[mPos] == '-' and mPattern[mPos + 1] != ']') {
+                ++mPos;
+                last = parseClassByte();
+            }
+            if (last < first)
+                fail("empty range");
+            for (unsigned b = first; b <= last; ++b)
+                bytes.set(b);
+        }
+        if (atEnd())
+            fail("missing ']'");
+        ++mPos;
+
+        return negated ? ~bytes : bytes;
+    }
+
+    unsigned char parseClassByte() {
+        const char c = mPattern[mPos++];
+        return c == '\\' ? parseEscape() : (unsigned char)c;
+    }
+
+    unsigned char parseEscape() {
+        if (atEnd())
+            fail("dangling '\\'");
+
+        const char c = mPattern[mPos++];
+        switch (c) {
+            case 'n':
+                return '\n';
+            case 't':
+                return '\t';
+            case 'r':
+                return '\r';
+            case '0':
+                return '\0';
+            case 'x': {
+                if (mPos + 2 > mPattern.size() or !isxdigit(mPattern[mPos]) or !isxdigit(mPattern[mPos + 1]))
+                    fail("\\x needs two hex digits");
+                const unsigned value = std::stoul(mPattern.substr(mPos, 2), nullptr, 16);
+                mPos += 2;
+                return value;
+            }
+            default:
+                return c;
+        }
+    }
+
+    std::vector<NfaState>& mStates;
+    std::string mPattern;
+    std::size_t mPos = 0;
+};
+
+bool isReservedWord(const std::string& pattern) {
+    return !pattern.empty() and std::all_of(pattern.begin(), pattern.end(), [](char c) { return c >= 'a' and c <= 'z'; });
+}
+
+std::vector<Rule> readRules(std::istream& spec) {
+    std::vector<Rule> rules;
+    std::string line;
+    for (unsigned lineNumber = 1; std::getline(spec, line); ++lineNumber) {
+        if (line.empty() or line[0] == '#')
+            continue;
+
+        const std::size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            throw std::runtime_error("line " + std::to_string(lineNumber) + ": expected 'NAME: pattern'");
+
+        std::string pattern = line.substr(colon + 1);
+        pattern.erase(0, pattern.find_first_not_of(' '));
+        pattern.erase(pattern.find_last_not_of(" \r") + 1);
+        rules.push_back({line.substr(0, colon), pattern, lineNumber});
+    }
+    return rules;
+}
+
+/*
+ * \class Dfa
+ * \brief Deterministic automaton over byte classes, state 0 is the dead state and 1 the start
+ */
+struct Dfa {
+    std::vector<int> classOf = std::vector<int>(256);
+    int numClasses = 0;
+    std::vector<std::vector<int>> transitions;
+    std::vector<int> accepts; /*!< Rule accepted in every state, or -1 */
+};
+
+std::vector<int> closure(const std::vector<NfaState>& nfa, std::vector<int> states) {
+    std::vector<bool> seen(nfa.size());
+    for (int state : states) seen[state] = true;
+
+    for (std::size_t i = 0; i < states.size(); ++i)
+        for (int next : nfa[states[i]].epsilon)
+            if (!seen[next]) {
+                seen[next] = true;
+                states.push_back(next);
+            }
+
+    std::sort(states.begin(), states.end());
+    return states;
+}
+
+Dfa buildDfa(const std::vector<NfaState>& nfa, int start) {
+    Dfa dfa;
+
+    // Bytes no edge tells apart share a class
+    std::map<std::vector<bool>, int> classes;
+    std::vector<int> representative;
+    for (unsigned b = 0; b < 256; ++b) {
+        std::vector<bool> signature;
+        for (const auto& state : nfa)
+            if (state.next >= 0)
+                signature.push_back(state.bytes.test(b));
+
+        auto [it, inserted] = classes.emplace(signature, classes.size());
+        if (inserted)
+            representative.push_back(b);
+        dfa.classOf[b] = it->second;
+    }
+    dfa.numClasses = classes.size();
+
+    std::map<std::vector<int>, int> ids{{{}, 0}};
+    std::vector<std::vector<int>> sets{{}};
+    ids.emplace(closure(nfa, {start}), 1);
+    sets.push_back(closure(nfa, {start}));
+
+    for (std::size_t current = 0; current < sets.size(); ++current) {
+        std::vector<int> row(dfa.numClasses);
+        for (int cls = 0; cls < dfa.numClasses; ++cls) {
+            std::vector<int> moved;
+            for (int state : sets[current])
+                if (nfa[state].next >= 0 and nfa[state].bytes.test(representative[cls]))
+                    moved.push_back(nfa[state].next);
+
+            std::vector<int> target = closure(nfa, moved);
+            auto [it, inserted] = ids.emplace(target, sets.size());
+            if (inserted)
+                sets.push_back(target);
+            row[cls] = it->second;
+        }
+        dfa.transitions.push_back(row);
+
+        // Rules written first win ties
+        int rule = -1;
+        for (int state : sets[current])
+            if (nfa[state].rule >= 0 and (rule < 0 or nfa[state].rule < rule))
+                rule = nfa[state].rule;
+        dfa.accepts.push_back(rule);
+    }
+
+    return dfa;
+}
+
+// Moore's partition refinement, states are only told apart by the token they accept
+Dfa minimize(const Dfa& dfa, const std::vector<Rule>& rules) {
+    const std::size_t size = dfa.transitions.size();
+    std::vector<int> block(size);
+    {
+        std::map<std::string, int> byToken;
+        for (std::size_t s = 0; s < size; ++s) {
+            const std::string token = dfa.accepts[s] < 0 ? "" : rules[dfa.accepts[s]].name;
+            block[s] = byToken.emplace(token, byToken.size()).first->second;
+        }
+    }
+
+    for (std::size_t numBlocks = 0;;) {
+        std::map<std::vector<int>, int> signatures;
+        std::vector<int> refined(size);
+        for (std::size_t s = 0; s < size; ++s) {
+            std::vector<int> signature{block[s]};
+            for (int target : dfa.transitions[s]) signature.push_back(block[target]);
+            refined[s] = signatures.emplace(signature, signatures.size()).first->second;
+        }
+        block = refined;
+        if (signatures.size() == numBlocks)
+            break;
+        numBlocks = signatures.size();
+    }
+
+    // Renumber so that the dead state stays 0 and the start state 1
+    std::vector<int> ids(size, -1);
+    int next = 0;
+    for (std::size_t s : {std::size_t(0), std::size_t(1)})
+        if (ids[block[s]] < 0)
+            ids[block[s]] = next++;
+    for (std::size_t s = 0; s < size; ++s)
+        if (ids[block[s]] < 0)
+            ids[block[s]] = next++;
+
+    if (ids[block[0]] == ids[block[1]])
+        throw std::runtime_error("the specification does not match anything");
+
+    Dfa minimal;
+    minimal.classOf = dfa.classOf;
+    minimal.numClasses = dfa.numClasses;
+    minimal.transitions.resize(next);
+    minimal.accepts.resize(next);
+    for (std::size_t s = 0; s < size; ++s) {
+        const int id = ids[block[s]];
+        minimal.accepts[id] = dfa.accepts[s];
+        minimal.transitions[id].clear();
+        for (int target : dfa.transitions[s]) minimal.transitions[id].push_back(ids[block[target]]);
+    }
+    return minimal;
+}
+
+template <typename T>
+void writeArray(std::ostream& out, const std::vector<T>& values, unsigned perLine) {
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        out << (i % perLine == 0 ? "    " : " ") << values[i] << ",";
+        if (i % perLine == perLine - 1 or i + 1 == values.size())
+            out << "\n";
+    }
+}
+
+void writeHeader(std::ostream& out, const Dfa& dfa, const std::vector<Rule>& rules, const std::vector<Rule>& words) {
+    const bool narrow = dfa.transitions.size() <= 256;
+
+    out << "// Generated by lexgen from spec/tokens.g, do not edit\n"
+        << "#pragma once\n\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n"
+        << "#include <parser/keywords.hpp>\n"
+        << "#include <parser/lexer.hpp>\n\n"
+        << "namespace Crust::DfaTables {\n\n"
+        << "using State = std::" << (narrow ? "uint8_t" : "uint16_t") << ";\n\n"
+        << "constexpr State DEAD = 0;\n"
+        << "constexpr State START = 1;\n"
+        << "constexpr std::size_t NUM_STATES = " << dfa.transitions.size() << ";\n"
+        << "constexpr std::size_t NUM_CLASSES = " << dfa.numClasses << ";\n"
+        << "constexpr std::uint8_t NO_TOKEN = 0xFF;\n\n"
+        << "static_assert((std::size_t)Lexer::Token::UNKNOWN < NO_TOKEN);\n\n";
+
+    out << "// Byte class of every byte\n"
+        << "inline constexpr std::uint8_t classOf[256] = {\n";
+    writeArray(out, dfa.classOf, 16);
+    out << "};\n\n";
+
+    std::vector<int> flat;
+    for (const auto& row : dfa.transitions) flat.insert(flat.end(), row.begin(), row.end());
+    out << "// Next state, indexed by state * NUM_CLASSES + class\n"
+        << "inline constexpr State transitions[NUM_STATES * NUM_CLASSES] = {\n";
+    writeArray(out, flat, 16);
+    out << "};\n\n";
+
+    std::vector<std::string> accepts;
+    for (int rule : dfa.accepts)
+        accepts.push_back(rule < 0 ? "NO_TOKEN" : "(std::uint8_t)Lexer::Token::" + rules[rule].name);
+    out << "// Token accepted in every state, or NO_TOKEN\n"
+        << "inline constexpr std::uint8_t accepts[NUM_STATES] = {\n";
+    writeArray(out, accepts, 1);
+    out << "};\n\n";
+
+    out << "// Reserved words of the specification are left to Keywords\n";
+    for (const auto& word : words)
+        out << "static_assert(Keywords::classify(\"" << word.pattern << "\") == Lexer::Token::" << word.name
+            << ", \"spec/tokens.g:" << word.line << ": Keywords does not know '" << word.pattern << "'\");\n";
+
+    out << "\n}  // namespace Crust::DfaTables\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <tokens.g> <output header>\n";
+        return 1;
+    }
+
+    std::ifstream spec(argv[1]);
+    if (!spec) {
+        std::cerr << "lexgen: cannot open " << argv[1] << "\n";
+        return 1;
+    }
+
+    try {
+        std::vector<Rule> rules;
+        std::vector<Rule> words;
+        for (auto& rule : readRules(spec))
+            (isReservedWord(rule.pattern) ? words : rules).push_back(rule);
+
+        std::vector<NfaState> nfa(1);
+        RegexCompiler compiler(nfa);
+        for (std::size_t i = 0; i < rules.size(); ++i) {
+            try {
+                Fragment fragment = compiler.compile(rules[i].pattern);
+                nfa[0].epsilon.push_back(fragment.start);
+                nfa[fragment.end].rule = i;
+            } catch (const std::runtime_error& error) {
+                throw std::runtime_error("line " + std::to_string(rules[i].line) + ": " + error.what());
+            }
+        }
+
+        const Dfa dfa = minimize(buildDfa(nfa, 0), rules);
+
+        std::ostringstream header;
+        writeHeader(header, dfa, rules, words);
+
+        std::ofstream out(argv[2]);
+        out << header.str();
+        if (!out) {
+            std::cerr << "lexgen: cannot write " << argv[2] << "\n";
+            return 1;
+        }
+    } catch (const std::runtime_error& error) {
+        std::cerr << argv[1] << ": " << error.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,484 @@
+/*
+ * parsegen: builds the LL(1) parse tables from spec/grammar.g
+ *
+ * Usage: parsegen <grammar.g> <output header>
+ *
+ * The FIRST and FOLLOW sets of every rule give the alternative to take on every token. Cells where
+ * several alternatives apply are told apart by the token after the first one, the only place where
+ * the grammar needs a second token. The header written holds the rules, their symbols and the dense
+ * prediction tables, see lib/src/parser/llparser.cpp for the driver.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using TokenNames = std::set<std::string>;
+
+const std::string EOF_TOKEN = "TOK_EOF";
+
+struct Symbol {
+    bool terminal;
+    int index; /*!< Of a terminal or of a rule */
+};
+
+struct Production {
+    int rule;
+    std::vector<Symbol> symbols;
+};
+
+struct Rule {
+    std::string name;
+    std::string error = "VAR_MISSING_IDENTIFIER";
+    unsigned line;
+    std::vector<int> productions;
+
+    bool nullable = false;
+    TokenNames first;
+    TokenNames follow;
+};
+
+// A token, or a class of tokens matched alike
+struct Terminal {
+    std::string name;
+    TokenNames tokens;
+};
+
+struct Grammar {
+    std::vector<Rule> rules;
+    std::vector<Production> productions;
+    std::vector<Terminal> terminals;
+};
+
+bool isSpliced(const Rule& rule) { return rule.name[0] == '_'; }
+
+std::string upper(std::string name) {
+    for (char& c : name) c = std::toupper((unsigned char)c);
+    return name;
+}
+
+std::vector<std::string> split(const std::string& text) {
+    std::istringstream stream(text);
+    std::vector<std::string> words;
+    for (std::string word; stream >> word;) words.push_back(word);
+    return words;
+}
+
+std::string trim(const std::string& text) {
+    const std::size_t begin = text.find_first_not_of(" \t\r");
+    return begin == std::string::npos ? "" : text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+}
+
+Grammar readGrammar(std::istream& spec) {
+    struct Definition {
+        std::string head;
+        std::string body;
+        unsigned line;
+    };
+    std::vector<Definition> definitions;
+    std::map<std::string, TokenNames> classes;
+
+    std::string line;
+    for (unsigned lineNumber = 1; std::getline(spec, line); ++lineNumber) {
+        if (trim(line).empty() or line[0] == '#')
+            continue;
+
+        const auto fail = [&](const std::string& message) {
+            return std::runtime_error("line " + std::to_string(lineNumber) + ": " + message);
+        };
+
+        if (std::isspace((unsigned char)line[0])) {
+            if (definitions.empty())
+                throw fail("continuation line without a rule");
+            definitions.back().body += " " + trim(line);
+            continue;
+        }
+
+        const std::size_t colon = line.find(':');
+        const std::size_t equals = line.find('=');
+        if (equals != std::string::npos and (colon == std::string::npos or equals < colon)) {
+            const std::string name = trim(line.substr(0, equals));
+            for (const std::string& token : split(line.substr(equals + 1))) classes[name].insert(token);
+            continue;
+        }
+        if (colon == std::string::npos)
+            throw fail("expected 'rule: alternatives' or 'CLASS = TOKENS'");
+
+        definitions.push_back({trim(line.substr(0, colon)), line.substr(colon + 1), lineNumber});
+    }
+    if (definitions.empty())
+        throw std::runtime_error("the grammar has no rule");
+
+    Grammar grammar;
+    std::map<std::string, int> ruleIds;
+    for (const auto& definition : definitions) {
+        Rule rule;
+        rule.line = definition.line;
+        rule.name = definition.head;
+
+        const std::size_t bracket = definition.head.find('[');
+        if (bracket != std::string::npos) {
+            rule.name = trim(definition.head.substr(0, bracket));
+            rule.error = trim(definition.head.substr(bracket + 1, definition.head.find(']') - bracket - 1));
+        }
+        if (!ruleIds.emplace(rule.name, grammar.rules.size()).second)
+            throw std::runtime_error("line " + std::to_string(rule.line) + ": rule '" + rule.name + "' defined twice");
+        grammar.rules.push_back(rule);
+    }
+
+    std::map<std::string, int> terminalIds;
+    for (std::size_t r = 0; r < definitions.size(); ++r) {
+        std::string alternatives = definitions[r].body + "|";
+        for (std::size_t bar; (bar = alternatives.find('|')) != std::string::npos; alternatives.erase(0, bar + 1)) {
+            Production production{(int)r, {}};
+            const std::vector<std::string> names = split(alternatives.substr(0, bar));
+            if (names.empty())
+                throw std::runtime_error("line " + std::to_string(definitions[r].line) + ": empty alternative, write %empty");
+
+            for (const std::string& name : names) {
+                if (name == "%empty")
+                    continue;
+
+                if (std::islower((unsigned char)name[0]) or name[0] == '_') {
+                    auto it = ruleIds.find(name);
+                    if (it == ruleIds.end())
+                        throw std::runtime_error("line " + std::to_string(definitions[r].line) + ": unknown rule '" + name + "'");
+                    production.symbols.push_back({false, it->second});
+                    continue;
+                }
+
+                auto [it, inserted] = terminalIds.emplace(name, grammar.terminals.size());
+                if (inserted) {
+                    auto cls = classes.find(name);
+                    grammar.terminals.push_back({name, cls != classes.end() ? cls->second : TokenNames{name}});
+                }
+                production.symbols.push_back({true, it->second});
+            }
+
+            grammar.rules[r].productions.push_back(grammar.productions.size());
+            grammar.productions.push_back(production);
+        }
+    }
+    return grammar;
+}
+
+// FIRST set of symbols[from...], and whether they may all derive the empty string
+std::pair<TokenNames, bool> firstOf(const Grammar& grammar, const std::vector<Symbol>& symbols, std::size_t from = 0) {
+    TokenNames first;
+    for (std::size_t i = from; i < symbols.size(); ++i) {
+        if (symbols[i].terminal) {
+            const TokenNames& tokens = grammar.terminals[symbols[i].index].tokens;
+            first.insert(tokens.begin(), tokens.end());
+            return {first, false};
+        }
+
+        const Rule& rule = grammar.rules[symbols[i].index];
+        first.insert(rule.first.begin(), rule.first.end());
+        if (!rule.nullable)
+            return {first, false};
+    }
+    return {first, true};
+}
+
+void computeSets(Grammar& grammar) {
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const auto& production : grammar.productions) {
+            Rule& rule = grammar.rules[production.rule];
+            const auto [first, nullable] = firstOf(grammar, production.symbols);
+
+            const std::size_t size = rule.first.size();
+            rule.first.insert(first.begin(), first.end());
+            changed |= rule.first.size() != size or (nullable and !rule.nullable);
+            rule.nullable |= nullable;
+        }
+    }
+
+    grammar.rules[0].follow.insert(EOF_TOKEN);
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const auto& production : grammar.productions)
+            for (std::size_t i = 0; i < production.symbols.size(); ++i) {
+                if (production.symbols[i].terminal)
+                    continue;
+
+                Rule& rule = grammar.rules[production.symbols[i].index];
+                auto [follow, nullable] = firstOf(grammar, production.symbols, i + 1);
+                if (nullable) {
+                    const TokenNames& parent = grammar.rules[production.rule].follow;
+                    follow.insert(parent.begin(), parent.end());
+                }
+
+                const std::size_t size = rule.follow.size();
+                rule.follow.insert(follow.begin(), follow.end());
+                changed |= rule.follow.size() != size;
+            }
+    }
+}
+
+// Tokens that may come right after a leading token in what symbols[from...] followed by tail derive
+TokenNames secondTokens(const Grammar& grammar, const std::vector<Symbol>& symbols, std::size_t from,
+                        const std::string& token, const TokenNames& tail) {
+    if (from == symbols.size())
+        return {};
+
+    auto [rest, nullable] = firstOf(grammar, symbols, from + 1);
+    if (nullable)
+        rest.insert(tail.begin(), tail.end());
+
+    if (symbols[from].terminal)
+        return grammar.terminals[symbols[from].index].tokens.count(token) ? rest : TokenNames{};
+
+    TokenNames second;
+    const Rule& rule = grammar.rules[symbols[from].index];
+    for (int p : rule.productions) {
+        const TokenNames found = secondTokens(grammar, grammar.productions[p].symbols, 0, token, rest);
+        second.insert(found.begin(), found.end());
+    }
+    if (rule.nullable) {
+        const TokenNames found = secondTokens(grammar, symbols, from + 1, token, tail);
+        second.insert(found.begin(), found.end());
+    }
+    return second;
+}
+
+struct Entry {
+    int row;
+    std::string token;
+    int value;
+};
+
+struct Tables {
+    std::vector<Entry> predict;
+    std::vector<Entry> second; /*!< Row is the conflict */
+    std::vector<int> defaults; /*!< Production of every conflict on the second tokens no alternative expects */
+};
+
+constexpr int CONFLICT = 0x80;
+
+Tables buildTables(const Grammar& grammar) {
+    Tables tables;
+    for (std::size_t r = 0; r < grammar.rules.size(); ++r) {
+        const Rule& rule = grammar.rules[r];
+
+        std::map<std::string, std::vector<int>> cells;
+        for (int p : rule.productions) {
+            auto [predicted, nullable] = firstOf(grammar, grammar.productions[p].symbols);
+            if (nullable)
+                predicted.insert(rule.follow.begin(), rule.follow.end());
+            for (const std::string& token : predicted) cells[token].push_back(p);
+        }
+
+        for (const auto& [token, alternatives] : cells) {
+            if (alternatives.size() == 1) {
+                tables.predict.push_back({(int)r, token, alternatives[0]});
+                continue;
+            }
+
+            const int conflict = tables.defaults.size();
+            tables.predict.push_back({(int)r, token, CONFLICT + conflict});
+            tables.defaults.push_back(alternatives.back());
+
+            std::map<std::string, int> seen;
+            for (int p : alternatives) {
+                const std::vector<Symbol>& symbols = grammar.productions[p].symbols;
+                if (symbols.empty())
+                    throw std::runtime_error("line " + std::to_string(rule.line) + ": '" + rule.name + "' may be empty and start with " + token);
+
+                for (const std::string& next : secondTokens(grammar, symbols, 0, token, rule.follow)) {
+                    if (!seen.emplace(next, p).second)
+                        throw std::runtime_error("line " + std::to_string(rule.line) + ": '" + rule.name + "' is ambiguous on " + token + " " + next);
+                    if (p != alternatives.back())
+                        tables.second.push_back({conflict, next, p});
+                }
+            }
+        }
+    }
+
+    if (grammar.productions.size() >= CONFLICT or tables.defaults.size() >= 0xFF - CONFLICT)
+        throw std::runtime_error("too many alternatives for the 8-bit tables");
+    return tables;
+}
+
+void writeTokens(std::ostream& out, const TokenNames& tokens) {
+    out << "TokenSet{";
+    const char* separator = "";
+    for (const std::string& token : tokens) {
+        if (token == EOF_TOKEN)
+            continue;
+        out << separator << "T::" << token;
+        separator = ", ";
+    }
+    out << "}";
+}
+
+void writeEntries(std::ostream& out, const char* name, const std::vector<Entry>& entries) {
+    out << "inline constexpr std::array<Entry, " << entries.size() << "> " << name << " = {{\n";
+    for (const Entry& entry : entries)
+        out << "    {" << entry.row << ", T::" << entry.token << ", " << entry.value << "},\n";
+    out << "}};\n\n";
+}
+
+void writeHeader(std::ostream& out, const Grammar& grammar, const Tables& tables) {
+    out << "// Generated by parsegen from spec/grammar.g, do not edit\n"
+        << "#pragma once\n\n"
+        << "#include <CFG/cfg.hpp>\n"
+        << "#include <CFG/first.hpp>\n"
+        << "#include <array>\n"
+        << "#include <common/errorlogger.hpp>\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n"
+        << "#include <parser/lexer.hpp>\n\n"
+        << "namespace Crust::LLTables {\n\n"
+        << "using Kind = CFGNode::NodeKind;\n"
+        << "using T = Lexer::Token;\n\n"
+        << "constexpr std::size_t NUM_TOKENS = (std::size_t)T::UNKNOWN + 1;\n"
+        << "constexpr std::size_t NUM_TERMINALS = " << grammar.terminals.size() << ";\n"
+        << "constexpr std::size_t NUM_RULES = " << grammar.rules.size() << ";\n"
+        << "constexpr std::size_t NUM_PRODUCTIONS = " << grammar.productions.size() << ";\n"
+        << "constexpr std::size_t NUM_CONFLICTS = " << tables.defaults.size() << ";\n"
+        << "constexpr std::uint8_t START = 0;\n"
+        << "constexpr std::uint8_t CONFLICT = " << CONFLICT << ";\n"
+        << "constexpr std::uint8_t NO_PRODUCTION = 0xFF;\n\n"
+        << "static_assert(NUM_TERMINALS + NUM_RULES <= 0x100);\n\n";
+
+    out << "struct Rule {\n"
+        << "    const char* name;\n"
+        << "    Kind kind;     /*!< Of the node built, ERROR for a spliced rule */\n"
+        << "    bool spliced;  /*!< Builds no node, its children go to the node of the rule using it */\n"
+        << "    bool nullable;\n"
+        << "    TokenSet skip; /*!< Tokens that can start or follow the rule, the others are skipped */\n"
+        << "    ErrorLogger::ErrorType error;\n"
+        << "};\n\n";
+
+    out << "inline constexpr Rule rules[NUM_RULES] = {\n";
+    for (const Rule& rule : grammar.rules) {
+        TokenNames skip = rule.first;
+        if (rule.nullable)
+            skip.insert(rule.follow.begin(), rule.follow.end());
+
+        out << "    {\"" << upper(rule.name) << "\", Kind::" << (isSpliced(rule) ? "ERROR" : upper(rule.name)) << ", "
+            << (isSpliced(rule) ? "true" : "false") << ", " << (rule.nullable ? "true" : "false") << ", ";
+        writeTokens(out, skip);
+        out << ", ErrorLogger::ErrorType::" << rule.error << "},\n";
+    }
+    out << "};\n\n";
+
+    out << "// Tokens matched by every terminal\n"
+        << "inline constexpr TokenSet terminals[NUM_TERMINALS] = {\n";
+    for (const Terminal& terminal : grammar.terminals) {
+        out << "    ";
+        writeTokens(out, terminal.tokens);
+        out << ",";
+        if (terminal.tokens.size() > 1)
+            out << "  // " << terminal.name;
+        out << "\n";
+    }
+    out << "};\n\n";
+
+    std::vector<int> symbols;
+    std::vector<int> offsets{0};
+    for (const auto& production : grammar.productions) {
+        for (const Symbol& symbol : production.symbols)
+            symbols.push_back(symbol.terminal ? symbol.index : grammar.terminals.size() + symbol.index);
+        offsets.push_back(symbols.size());
+    }
+    out << "// Symbols of the productions, a terminal below NUM_TERMINALS and NUM_TERMINALS + a rule above\n"
+        << "inline constexpr std::uint8_t symbols[] = {\n";
+    for (std::size_t p = 0; p < grammar.productions.size(); ++p) {
+        if (offsets[p] == offsets[p + 1])
+            continue;
+        out << "   ";
+        for (int i = offsets[p]; i < offsets[p + 1]; ++i) out << " " << symbols[i] << ",";
+        out << "\n";
+    }
+    out << "};\n\n"
+        << "// Production p is symbols[productions[p]] up to symbols[productions[p + 1]]\n"
+        << "inline constexpr std::uint16_t productions[NUM_PRODUCTIONS + 1] = {\n   ";
+    for (int offset : offsets) out << " " << offset << ",";
+    out << "\n};\n\n";
+
+    out << "struct Entry {\n"
+        << "    std::uint8_t row;\n"
+        << "    T token;\n"
+        << "    std::uint8_t value;\n"
+        << "};\n\n";
+    writeEntries(out, "predictEntries", tables.predict);
+    writeEntries(out, "secondEntries", tables.second);
+    out << "inline constexpr std::array<std::uint8_t, NUM_CONFLICTS> secondDefaults = {";
+    for (std::size_t c = 0; c < tables.defaults.size(); ++c) out << (c ? ", " : "") << tables.defaults[c];
+    out << "};\n\n";
+
+    out << "// Production of rule on token, indexed by rule * NUM_TOKENS + token. From CONFLICT on, the row\n"
+        << "// of second to look the next token up in\n"
+        << "inline constexpr auto predict = [] {\n"
+        << "    std::array<std::uint8_t, NUM_RULES * NUM_TOKENS> table{};\n"
+        << "    table.fill(NO_PRODUCTION);\n"
+        << "    for (const Entry& entry : predictEntries) table[entry.row * NUM_TOKENS + (std::size_t)entry.token] = entry.value;\n"
+        << "    return table;\n"
+        << "}();\n\n"
+        << "// Production of a conflict on the next token, indexed by (entry - CONFLICT) * NUM_TOKENS + token\n"
+        << "inline constexpr auto second = [] {\n"
+        << "    std::array<std::uint8_t, NUM_CONFLICTS * NUM_TOKENS> table{};\n"
+        << "    for (std::size_t conflict = 0; conflict < NUM_CONFLICTS; ++conflict)\n"
+        << "        for (std::size_t token = 0; token < NUM_TOKENS; ++token) table[conflict * NUM_TOKENS + token] = secondDefaults[conflict];\n"
+        << "    for (const Entry& entry : secondEntries) table[entry.row * NUM_TOKENS + (std::size_t)entry.token] = entry.value;\n"
+        << "    return table;\n"
+        << "}();\n\n";
+
+    out << "// The recursive descent parser skips to the same tokens\n";
+    for (std::size_t r = 0; r < grammar.rules.size(); ++r) {
+        const Rule& rule = grammar.rules[r];
+        if (isSpliced(rule))
+            continue;
+        out << "static_assert(rules[" << r << "].skip == FirstSets::get(Kind::" << upper(rule.name) << "), \"spec/grammar.g:"
+            << rule.line << ": FirstSets disagrees on '" << rule.name << "'\");\n";
+    }
+
+    out << "\n}  // namespace Crust::LLTables\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <grammar.g> <output header>\n";
+        return 1;
+    }
+
+    std::ifstream spec(argv[1]);
+    if (!spec) {
+        std::cerr << "parsegen: cannot open " << argv[1] << "\n";
+        return 1;
+    }
+
+    try {
+        Grammar grammar = readGrammar(spec);
+        computeSets(grammar);
+        const Tables tables = buildTables(grammar);
+
+        std::ostringstream header;
+        writeHeader(header, grammar, tables);
+
+        std::ofstream out(argv[2]);
+        out << header.str();
+        if (!out) {
+            std::cerr << "parsegen: cannot write " << argv[2] << "\n";
+            return 1;
+        }
+    } catch (const std::runtime_error& error) {
+        std::cerr << argv[1] << ": " << error.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}